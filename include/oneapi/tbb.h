@@ -50,6 +50,7 @@
 #include "oneapi/tbb/info.h"
 #include "oneapi/tbb/null_mutex.h"
 #include "oneapi/tbb/null_rw_mutex.h"
+#include "oneapi/tbb/parallel_algorithms.h"
 #include "oneapi/tbb/parallel_for.h"
 #include "oneapi/tbb/parallel_for_each.h"
 #include "oneapi/tbb/parallel_invoke.h"
@@ -64,6 +65,8 @@
 #include "oneapi/tbb/spin_rw_mutex.h"
 #include "oneapi/tbb/task.h"
 #include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_coroutine.h"
+#include "oneapi/tbb/task_dag.h"
 #include "oneapi/tbb/task_group.h"
 #include "oneapi/tbb/task_scheduler_observer.h"
 #include "oneapi/tbb/tbb_allocator.h"
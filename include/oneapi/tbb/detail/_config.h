@@ -249,6 +249,15 @@
 
 #define __TBB_RESUMABLE_TASKS                           (!__TBB_WIN8UI_SUPPORT && !__ANDROID__)
 
+#if defined(__has_include)
+    #if __TBB_CPP20_PRESENT && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+        #define __TBB_CPP20_COROUTINES_PRESENT 1
+    #endif
+#endif
+#ifndef __TBB_CPP20_COROUTINES_PRESENT
+    #define __TBB_CPP20_COROUTINES_PRESENT 0
+#endif
+
 /* This macro marks incomplete code or comments describing ideas which are considered for the future.
  * See also for plain comment with TODO and FIXME marks for small improvement opportunities.
  */
@@ -39,16 +39,33 @@ using slot_id = unsigned short;
 constexpr slot_id no_slot = slot_id(~0);
 constexpr slot_id any_slot = slot_id(~1);
 
+//! Priority of a spawned task relative to the other tasks of the arena
+/** High priority tasks are taken ahead of the local task pool of any thread in the arena;
+    low priority tasks are taken only when there is nothing to steal, by a thread that is
+    allowed to steal at its current dispatch level.
+    High priority relies on the critical task stream, so unless the library is built with
+    __TBB_PREVIEW_CRITICAL_TASKS such tasks are spawned as the normal ones. **/
+enum class task_priority {
+    low,
+    normal,
+    high
+};
+
 class task;
 class wait_context;
 class task_group_context;
 struct execution_data;
+struct coroutine_stack_statistics;
 }
 
 namespace r1 {
 //! Task spawn/wait entry points
 void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx);
 void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::slot_id id);
+void __TBB_EXPORTED_FUNC spawn(d1::task* const* tasks, std::size_t num_tasks, d1::task_group_context& ctx);
+d1::task* __TBB_EXPORTED_FUNC spawn_deferred_mail(d1::task& t, d1::task_group_context& ctx, d1::slot_id id);
+void __TBB_EXPORTED_FUNC mail_proxies(d1::task* const* proxies, std::size_t num_proxies);
+void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::task_priority priority);
 void __TBB_EXPORTED_FUNC execute_and_wait(d1::task& t, d1::task_group_context& t_ctx, d1::wait_context&, d1::task_group_context& w_ctx);
 void __TBB_EXPORTED_FUNC wait(d1::wait_context&, d1::task_group_context& ctx);
 d1::slot_id __TBB_EXPORTED_FUNC execution_slot(const d1::execution_data*);
@@ -61,6 +78,7 @@ using suspend_callback_type = void(*)(void*, suspend_point_type*);
 void __TBB_EXPORTED_FUNC suspend(suspend_callback_type suspend_callback, void* user_callback);
 void __TBB_EXPORTED_FUNC resume(suspend_point_type* tag);
 suspend_point_type* __TBB_EXPORTED_FUNC current_suspend_point();
+bool __TBB_EXPORTED_FUNC query_coroutine_stack_statistics(d1::coroutine_stack_statistics&);
 void __TBB_EXPORTED_FUNC notify_waiters(std::uintptr_t wait_ctx_tag);
 
 class thread_data;
@@ -92,6 +110,26 @@ void suspend(F f) {
 inline void resume(suspend_point tag) {
     r1::resume(tag);
 }
+
+//! Activity counters of the process-wide cache of the stacks of the suspended tasks
+struct coroutine_stack_statistics {
+    //! Number of stacks allocated from the system
+    std::uint64_t stacks_allocated{0};
+    //! Number of stacks taken from the cache
+    std::uint64_t stacks_reused{0};
+    //! Number of stacks returned to the system
+    std::uint64_t stacks_released{0};
+    //! Number of stacks in the cache
+    std::uint64_t stacks_cached{0};
+    //! Total size in bytes of the stacks in the cache, not counting the guard pages
+    std::uint64_t cached_bytes{0};
+};
+
+//! Fills the counters of the stack cache
+/** Returns false if the platform does not cache the stacks, e.g. when they are managed by the system. **/
+inline bool query_coroutine_stack_statistics(coroutine_stack_statistics& stats) {
+    return r1::query_coroutine_stack_statistics(stats);
+}
 #endif /* __TBB_RESUMABLE_TASKS */
 
 // TODO align wait_context on cache lane
@@ -192,6 +230,36 @@ inline void spawn(task& t, task_group_context& ctx, slot_id id) {
     r1::spawn(t, ctx, id);
 }
 
+//! Spawns several tasks at once
+/** The tasks become visible to other threads together, and the arena is notified about new work
+    only once. The last task of the batch is the first one taken by the spawning thread. **/
+inline void spawn(task* const* tasks, std::size_t num_tasks, task_group_context& ctx) {
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        call_itt_task_notify(releasing, tasks[i]);
+    }
+    r1::spawn(tasks, num_tasks, ctx);
+}
+
+//! Spawns the task to the local task pool but postpones mailing it to the slot
+/** Returns the proxy to be passed to mail_proxies, or nullptr if the task is not mailed: its
+    affinity is no_slot, the spawning thread, or a slot that is not occupied by any thread.
+    The task can be stolen as soon as it is spawned; only the affine thread has to wait
+    for the mail. **/
+inline task* spawn_deferred_mail(task& t, task_group_context& ctx, slot_id id) {
+    call_itt_task_notify(releasing, &t);
+    return r1::spawn_deferred_mail(t, ctx, id);
+}
+
+//! Mails the proxies returned by spawn_deferred_mail; the proxies for the same slot are mailed at once
+inline void mail_proxies(task* const* proxies, std::size_t num_proxies) {
+    r1::mail_proxies(proxies, num_proxies);
+}
+
+inline void spawn(task& t, task_group_context& ctx, task_priority priority) {
+    call_itt_task_notify(releasing, &t);
+    r1::spawn(t, ctx, priority);
+}
+
 inline void execute_and_wait(task& t, task_group_context& t_ctx, wait_context& wait_ctx, task_group_context& w_ctx) {
     r1::execute_and_wait(t, t_ctx, wait_ctx, w_ctx);
     call_itt_task_notify(acquired, &wait_ctx);
@@ -65,9 +65,34 @@ public:
 #else
         reserved1, // not a public parameter
 #endif
+        wait_policy,
+        allotment_policy,
+        coroutine_stack_cache_size, // maximal total size in bytes of the cached stacks of the suspended tasks
         parameter_max // insert new parameters above this point
     };
 
+    //! Values of the wait_policy parameter
+    /** Define how long idle worker threads spin looking for work before they leave the arena.
+        If several policies are requested, the most latency-oriented one is applied. **/
+    enum wait_policy_mode {
+        //! Spin long enough to pick up work that comes after long pauses
+        wait_latency_first,
+        //! Spin about twice as long as recent idle gaps last, give up early if they are long
+        wait_balanced,
+        //! Spin only to catch short idle gaps
+        wait_power_first
+    };
+
+    //! Values of the allotment_policy parameter
+    /** Define how fast worker threads move between arenas when the demand of the arenas changes.
+        If several policies are requested, the most responsive one is applied. **/
+    enum allotment_policy_mode {
+        //! Workers leave an arena as soon as their share of the workers is reduced
+        allotment_responsive,
+        //! Workers stay in an arena that still has work for some time before moving to another one
+        allotment_stable
+    };
+
     global_control(parameter p, std::size_t value) :
         my_value(value), my_reserved(), my_param(p) {
         suppress_unused_warning(my_reserved);
@@ -82,6 +107,10 @@ public:
 #endif
         if (my_param==max_allowed_parallelism)
             __TBB_ASSERT_RELEASE(my_value>0, "max_allowed_parallelism cannot be 0.");
+        if (my_param==wait_policy)
+            __TBB_ASSERT_RELEASE(my_value<=wait_power_first, "Unknown wait policy.");
+        if (my_param==allotment_policy)
+            __TBB_ASSERT_RELEASE(my_value<=allotment_stable, "Unknown allotment policy.");
         r1::create(*this);
     }
 
@@ -0,0 +1,770 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_parallel_algorithms_H
+#define __TBB_parallel_algorithms_H
+
+#include "detail/_config.h"
+#include "detail/_namespace_injection.h"
+#include "detail/_utils.h"
+
+#include "blocked_range.h"
+#include "partitioner.h"
+#include "parallel_for.h"
+#include "parallel_reduce.h"
+#include "parallel_scan.h"
+#include "task_arena.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace tbb {
+namespace detail {
+namespace d1 {
+
+//! Returns the number of pieces the algorithms divide a sequence into for the given minimal piece size
+inline std::size_t algorithm_num_pieces( std::size_t size, std::size_t min_piece_size ) {
+    constexpr std::size_t pieces_per_thread = 4;
+    std::size_t num_pieces = (std::min)(size / min_piece_size,
+                                        std::size_t(r1::max_concurrency(nullptr)) * pieces_per_thread);
+    return (std::max)(num_pieces, std::size_t(1));
+}
+
+//! Body of parallel_transform_reduce
+/** Holds no value until the first element is seen, so the reduction needs no identity.
+    @ingroup algorithms */
+template<typename Value, typename ReduceOperation, typename Transform>
+class transform_reduce_body {
+    const ReduceOperation& my_reduce;
+    const Transform& my_transform;
+    Value my_value;
+    bool my_has_value;
+
+public:
+    void operator=( const transform_reduce_body& ) = delete;
+
+    transform_reduce_body( const Value& init, const ReduceOperation& reduce, const Transform& transform )
+        : my_reduce(reduce), my_transform(transform), my_value(init), my_has_value(false) {}
+
+    transform_reduce_body( transform_reduce_body& other, split )
+        : my_reduce(other.my_reduce), my_transform(other.my_transform)
+        , my_value(other.my_value), my_has_value(false) {}
+
+    void operator()( const blocked_range<std::size_t>& range ) {
+        std::size_t i = range.begin();
+        if( !my_has_value && i != range.end() ) {
+            my_value = my_transform(i++);
+            my_has_value = true;
+        }
+        for( ; i != range.end(); ++i ) {
+            my_value = my_reduce(my_value, my_transform(i));
+        }
+    }
+
+    void join( transform_reduce_body& rhs ) {
+        if( rhs.my_has_value ) {
+            my_value = my_has_value ? my_reduce(my_value, rhs.my_value) : rhs.my_value;
+            my_has_value = true;
+        }
+    }
+
+    Value result( const Value& init ) const {
+        return my_has_value ? my_reduce(init, my_value) : init;
+    }
+};
+
+//! Applies the unary transformation to the element with the given index
+template<typename InputIterator, typename UnaryTransform>
+struct unary_index_transform {
+    InputIterator first;
+    const UnaryTransform& transform;
+    auto operator()( std::size_t i ) const -> decltype(transform(first[i])) {
+        return transform(first[i]);
+    }
+};
+
+//! Applies the binary transformation to the elements of two sequences with the given index
+template<typename InputIterator1, typename InputIterator2, typename BinaryTransform>
+struct binary_index_transform {
+    InputIterator1 first1;
+    InputIterator2 first2;
+    const BinaryTransform& transform;
+    auto operator()( std::size_t i ) const -> decltype(transform(first1[i], first2[i])) {
+        return transform(first1[i], first2[i]);
+    }
+};
+
+//! Reduces the transformed indices [0,size) starting with init
+template<typename Value, typename ReduceOperation, typename Transform>
+Value do_parallel_transform_reduce( std::size_t size, Value init, const ReduceOperation& reduce,
+                                    const Transform& transform )
+{
+    transform_reduce_body<Value, ReduceOperation, Transform> body(init, reduce, transform);
+    parallel_reduce(blocked_range<std::size_t>(0, size), body, auto_partitioner());
+    return body.result(init);
+}
+
+//! Body of the stream compaction algorithms.
+/** The pre-scan counts the selected elements of a subrange; the final scan also writes them
+    to the positions that follow the selected elements of the preceding subranges.
+    @ingroup algorithms */
+template<typename InputIterator, typename OutputIterator, typename Selector, bool IsMove>
+class compaction_scan_body {
+    InputIterator my_first;
+    OutputIterator my_result;
+    const Selector& my_selector;
+    std::size_t my_count;
+
+    template<typename Destination, typename Source>
+    static void store( Destination&& destination, Source&& source, std::true_type ) {
+        destination = std::move(source);
+    }
+
+    template<typename Destination, typename Source>
+    static void store( Destination&& destination, Source&& source, std::false_type ) {
+        destination = source;
+    }
+
+public:
+    void operator=( const compaction_scan_body& ) = delete;
+
+    compaction_scan_body( InputIterator first, OutputIterator result, const Selector& selector )
+        : my_first(first), my_result(result), my_selector(selector), my_count(0) {}
+
+    compaction_scan_body( compaction_scan_body& other, split )
+        : my_first(other.my_first), my_result(other.my_result), my_selector(other.my_selector), my_count(0) {}
+
+    template<typename Tag>
+    void operator()( const blocked_range<std::size_t>& range, Tag ) {
+        std::size_t count = my_count;
+        for( std::size_t i = range.begin(); i != range.end(); ++i ) {
+            if( my_selector(i) ) {
+                if( Tag::is_final_scan() ) {
+                    store(my_result[count], my_first[i], std::integral_constant<bool, IsMove>());
+                }
+                ++count;
+            }
+        }
+        my_count = count;
+    }
+
+    void reverse_join( compaction_scan_body& left ) { my_count += left.my_count; }
+    void assign( compaction_scan_body& other ) { my_count = other.my_count; }
+
+    std::size_t count() const { return my_count; }
+};
+
+//! Selects the elements that satisfy the predicate
+template<typename InputIterator, typename Predicate>
+struct predicate_selector {
+    InputIterator first;
+    const Predicate& pred;
+    bool operator()( std::size_t i ) const { return bool(pred(first[i])); }
+};
+
+//! Selects the elements that are not equal to the preceding one
+template<typename InputIterator, typename BinaryPredicate>
+struct unique_selector {
+    InputIterator first;
+    const BinaryPredicate& pred;
+    bool operator()( std::size_t i ) const { return i == 0 || !pred(first[i - 1], first[i]); }
+};
+
+//! Selects the elements marked by the flags
+struct flag_selector {
+    const unsigned char* flags;
+    bool operator()( std::size_t i ) const { return flags[i] != 0; }
+};
+
+//! Writes the selected elements of [first,first+size) to result; returns their number
+template<bool IsMove, typename InputIterator, typename OutputIterator, typename Selector>
+std::size_t do_parallel_compaction( InputIterator first, std::size_t size, OutputIterator result,
+                                    const Selector& selector )
+{
+    compaction_scan_body<InputIterator, OutputIterator, Selector, IsMove> body(first, result, selector);
+    parallel_scan(blocked_range<std::size_t>(0, size), body, auto_partitioner());
+    return body.count();
+}
+
+//! Body of parallel_partition_copy.
+/** Counts the elements that satisfy the predicate; the other ones precede the subrange
+    in the number of the elements before it minus that count.
+    @ingroup algorithms */
+template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+class partition_copy_scan_body {
+    InputIterator my_first;
+    OutputIterator1 my_result_true;
+    OutputIterator2 my_result_false;
+    const Predicate& my_pred;
+    std::size_t my_count;
+
+public:
+    void operator=( const partition_copy_scan_body& ) = delete;
+
+    partition_copy_scan_body( InputIterator first, OutputIterator1 result_true, OutputIterator2 result_false,
+                              const Predicate& pred )
+        : my_first(first), my_result_true(result_true), my_result_false(result_false), my_pred(pred), my_count(0) {}
+
+    partition_copy_scan_body( partition_copy_scan_body& other, split )
+        : my_first(other.my_first), my_result_true(other.my_result_true), my_result_false(other.my_result_false)
+        , my_pred(other.my_pred), my_count(0) {}
+
+    template<typename Tag>
+    void operator()( const blocked_range<std::size_t>& range, Tag ) {
+        std::size_t count = my_count;
+        for( std::size_t i = range.begin(); i != range.end(); ++i ) {
+            if( my_pred(my_first[i]) ) {
+                if( Tag::is_final_scan() ) {
+                    my_result_true[count] = my_first[i];
+                }
+                ++count;
+            } else if( Tag::is_final_scan() ) {
+                my_result_false[i - count] = my_first[i];
+            }
+        }
+        my_count = count;
+    }
+
+    void reverse_join( partition_copy_scan_body& left ) { my_count += left.my_count; }
+    void assign( partition_copy_scan_body& other ) { my_count = other.my_count; }
+
+    std::size_t count() const { return my_count; }
+};
+
+//! Partitions every block of the sequence in place and records the number of its selected elements
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename Predicate>
+class partition_block_body {
+    RandomAccessIterator my_first;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    std::size_t* my_counts;
+    const Predicate& my_pred;
+
+public:
+    partition_block_body( RandomAccessIterator first, std::size_t size, std::size_t block_size,
+                          std::size_t* counts, const Predicate& pred )
+        : my_first(first), my_size(size), my_block_size(block_size), my_counts(counts), my_pred(pred) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            RandomAccessIterator block_begin = my_first + b * my_block_size;
+            RandomAccessIterator block_end = my_first + (std::min)(my_size, (b + 1) * my_block_size);
+            my_counts[b] = std::size_t(std::partition(block_begin, block_end, my_pred) - block_begin);
+        }
+    }
+};
+
+//! Positions [begin,end) of misplaced elements; rank is the number of the misplaced elements before them
+struct partition_interval {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t rank;
+};
+
+//! Finds the interval that holds the misplaced element of the given rank
+inline std::size_t find_partition_interval( const std::vector<partition_interval>& intervals, std::size_t rank ) {
+    std::size_t low = 0, high = intervals.size();
+    while( high - low > 1 ) {
+        std::size_t middle = low + (high - low) / 2;
+        if( intervals[middle].rank <= rank ) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+//! Swaps the misplaced selected elements with the misplaced rejected ones
+/** The k-th rejected element in front of the partition point is swapped with the k-th selected
+    element after it, so any range of ranks can be processed independently.
+    @ingroup algorithms */
+template<typename RandomAccessIterator>
+class partition_swap_body {
+    RandomAccessIterator my_first;
+    const std::vector<partition_interval>& my_rejected;
+    const std::vector<partition_interval>& my_selected;
+
+public:
+    partition_swap_body( RandomAccessIterator first, const std::vector<partition_interval>& rejected,
+                         const std::vector<partition_interval>& selected )
+        : my_first(first), my_rejected(rejected), my_selected(selected) {}
+
+    void operator()( const blocked_range<std::size_t>& ranks ) const {
+        std::size_t r = find_partition_interval(my_rejected, ranks.begin());
+        std::size_t s = find_partition_interval(my_selected, ranks.begin());
+        std::size_t rejected_pos = my_rejected[r].begin + (ranks.begin() - my_rejected[r].rank);
+        std::size_t selected_pos = my_selected[s].begin + (ranks.begin() - my_selected[s].rank);
+        for( std::size_t k = ranks.begin(); k != ranks.end(); ++k ) {
+            if( rejected_pos == my_rejected[r].end ) {
+                rejected_pos = my_rejected[++r].begin;
+            }
+            if( selected_pos == my_selected[s].end ) {
+                selected_pos = my_selected[++s].begin;
+            }
+            std::iter_swap(my_first + rejected_pos++, my_first + selected_pos++);
+        }
+    }
+};
+
+//! Computes the flags of the elements that are not equal to the preceding one
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename BinaryPredicate>
+class unique_flags_body {
+    RandomAccessIterator my_first;
+    unsigned char* my_flags;
+    const BinaryPredicate& my_pred;
+
+public:
+    unique_flags_body( RandomAccessIterator first, unsigned char* flags, const BinaryPredicate& pred )
+        : my_first(first), my_flags(flags), my_pred(pred) {}
+
+    void operator()( const blocked_range<std::size_t>& range ) const {
+        unique_selector<RandomAccessIterator, BinaryPredicate> selector{my_first, my_pred};
+        for( std::size_t i = range.begin(); i != range.end(); ++i ) {
+            my_flags[i] = selector(i);
+        }
+    }
+};
+
+//! Moves [first,first+size) to result
+/** @ingroup algorithms */
+template<typename InputIterator, typename OutputIterator>
+class move_range_body {
+    InputIterator my_first;
+    OutputIterator my_result;
+
+public:
+    move_range_body( InputIterator first, OutputIterator result ) : my_first(first), my_result(result) {}
+
+    void operator()( const blocked_range<std::size_t>& range ) const {
+        for( std::size_t i = range.begin(); i != range.end(); ++i ) {
+            my_result[i] = std::move(my_first[i]);
+        }
+    }
+};
+
+//! Output iterator that only counts the assigned elements
+class counting_output_iterator {
+    std::size_t* my_count;
+
+public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    explicit counting_output_iterator( std::size_t* count ) : my_count(count) {}
+
+    template<typename T>
+    counting_output_iterator& operator=( const T& ) {
+        ++*my_count;
+        return *this;
+    }
+    counting_output_iterator& operator*() { return *this; }
+    counting_output_iterator& operator++() { return *this; }
+    counting_output_iterator operator++( int ) { return *this; }
+};
+
+//! Calls std::merge
+struct merge_operation {
+    template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result, const Compare& comp ) const {
+        return std::merge(first1, last1, first2, last2, result, comp);
+    }
+};
+
+//! Calls std::set_union
+struct set_union_operation {
+    template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result, const Compare& comp ) const {
+        return std::set_union(first1, last1, first2, last2, result, comp);
+    }
+};
+
+//! Calls std::set_intersection
+struct set_intersection_operation {
+    template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result, const Compare& comp ) const {
+        return std::set_intersection(first1, last1, first2, last2, result, comp);
+    }
+};
+
+//! Applies the operation on sorted sequences to the pieces with the matching keys.
+/** The pieces are bounded by the lower bounds of the same keys in both sequences, so the equivalent
+    elements always fall into the same piece and the pieces do not depend on each other.
+    If the output size of a piece is not known in advance, the first pass counts it.
+    @ingroup algorithms */
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare, typename Operation>
+class sorted_pieces_body {
+    InputIterator1 my_first1;
+    InputIterator2 my_first2;
+    OutputIterator my_result;
+    const std::size_t* my_bounds1;
+    const std::size_t* my_bounds2;
+    std::size_t* my_offsets;
+    bool my_is_counting;
+    const Compare& my_comp;
+
+public:
+    sorted_pieces_body( InputIterator1 first1, InputIterator2 first2, OutputIterator result,
+                        const std::size_t* bounds1, const std::size_t* bounds2, std::size_t* offsets,
+                        bool is_counting, const Compare& comp )
+        : my_first1(first1), my_first2(first2), my_result(result), my_bounds1(bounds1), my_bounds2(bounds2)
+        , my_offsets(offsets), my_is_counting(is_counting), my_comp(comp) {}
+
+    void operator()( const blocked_range<std::size_t>& pieces ) const {
+        for( std::size_t p = pieces.begin(); p != pieces.end(); ++p ) {
+            if( my_is_counting ) {
+                std::size_t count = 0;
+                Operation()(my_first1 + my_bounds1[p], my_first1 + my_bounds1[p + 1],
+                            my_first2 + my_bounds2[p], my_first2 + my_bounds2[p + 1],
+                            counting_output_iterator(&count), my_comp);
+                my_offsets[p] = count;
+            } else {
+                Operation()(my_first1 + my_bounds1[p], my_first1 + my_bounds1[p + 1],
+                            my_first2 + my_bounds2[p], my_first2 + my_bounds2[p + 1],
+                            my_result + my_offsets[p], my_comp);
+            }
+        }
+    }
+};
+
+//! Applies the operation to the sorted sequences in parallel; returns the end of the output.
+/** If IsSizeKnown, the output of a piece has as many elements as its inputs, as with std::merge.
+    @ingroup algorithms */
+template<typename Operation, bool IsSizeKnown, typename InputIterator1, typename InputIterator2,
+         typename OutputIterator, typename Compare>
+OutputIterator do_parallel_sorted_operation( InputIterator1 first1, InputIterator1 last1,
+                                             InputIterator2 first2, InputIterator2 last2,
+                                             OutputIterator result, const Compare& comp )
+{
+    constexpr std::size_t min_piece_size = 8 * 1024;
+    const std::size_t size1 = std::size_t(last1 - first1);
+    const std::size_t size2 = std::size_t(last2 - first2);
+    const std::size_t num_pieces = algorithm_num_pieces(size1 + size2, min_piece_size);
+    // Counting the output doubles the work, which only pays off with several threads
+    if( num_pieces == 1 || (!IsSizeKnown && r1::max_concurrency(nullptr) == 1) ) {
+        return Operation()(first1, last1, first2, last2, result, comp);
+    }
+
+    // Take the keys from the longer sequence, so the pieces are about the same size
+    std::vector<std::size_t> bounds1(num_pieces + 1), bounds2(num_pieces + 1);
+    bounds1[0] = bounds2[0] = 0;
+    bounds1[num_pieces] = size1;
+    bounds2[num_pieces] = size2;
+    for( std::size_t p = 1; p < num_pieces; ++p ) {
+        if( size1 >= size2 ) {
+            const auto& key = first1[size1 / num_pieces * p];
+            bounds1[p] = std::size_t(std::lower_bound(first1, last1, key, comp) - first1);
+            bounds2[p] = std::size_t(std::lower_bound(first2, last2, key, comp) - first2);
+        } else {
+            const auto& key = first2[size2 / num_pieces * p];
+            bounds1[p] = std::size_t(std::lower_bound(first1, last1, key, comp) - first1);
+            bounds2[p] = std::size_t(std::lower_bound(first2, last2, key, comp) - first2);
+        }
+    }
+
+    using body_type = sorted_pieces_body<InputIterator1, InputIterator2, OutputIterator, Compare, Operation>;
+    std::vector<std::size_t> offsets(num_pieces);
+    if( IsSizeKnown ) {
+        for( std::size_t p = 0; p < num_pieces; ++p ) {
+            offsets[p] = bounds1[p] + bounds2[p];
+        }
+    } else {
+        parallel_for(blocked_range<std::size_t>(0, num_pieces),
+                     body_type(first1, first2, result, bounds1.data(), bounds2.data(), offsets.data(),
+                               /*is_counting=*/true, comp),
+                     static_partitioner());
+        std::size_t offset = 0;
+        for( std::size_t p = 0; p < num_pieces; ++p ) {
+            std::size_t count = offsets[p];
+            offsets[p] = offset;
+            offset += count;
+        }
+        offsets.push_back(offset);
+    }
+    parallel_for(blocked_range<std::size_t>(0, num_pieces),
+                 body_type(first1, first2, result, bounds1.data(), bounds2.data(), offsets.data(),
+                           /*is_counting=*/false, comp),
+                 static_partitioner());
+    return result + (IsSizeKnown ? size1 + size2 : offsets[num_pieces]);
+}
+
+/** \name parallel_transform_reduce
+    Like std::transform_reduce, the reduction shall be associative and commutative. **/
+//@{
+
+//! Reduces the transformed elements of [first,last) starting with init
+/** @ingroup algorithms **/
+template<typename InputIterator, typename T, typename BinaryReduce, typename UnaryTransform>
+T parallel_transform_reduce( InputIterator first, InputIterator last, T init,
+                             BinaryReduce reduce, UnaryTransform transform )
+{
+    unary_index_transform<InputIterator, UnaryTransform> index_transform{first, transform};
+    return do_parallel_transform_reduce(std::size_t(last - first), init, reduce, index_transform);
+}
+
+//! Reduces the pairwise transformed elements of [first1,last1) and the sequence at first2 starting with init
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename T, typename BinaryReduce, typename BinaryTransform>
+T parallel_transform_reduce( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init,
+                             BinaryReduce reduce, BinaryTransform transform )
+{
+    binary_index_transform<InputIterator1, InputIterator2, BinaryTransform> index_transform{first1, first2, transform};
+    return do_parallel_transform_reduce(std::size_t(last1 - first1), init, reduce, index_transform);
+}
+
+//! Computes the inner product of [first1,last1) and the sequence at first2 starting with init
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename T>
+T parallel_transform_reduce( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init ) {
+    return parallel_transform_reduce(first1, last1, first2, init, std::plus<T>(), std::multiplies<T>());
+}
+//@}
+
+/** \name parallel_copy_if, parallel_unique_copy, parallel_partition_copy
+    Stream compaction over parallel_scan: the predicate may be called twice for an element,
+    so it shall have no side effects. The output shall be a random access iterator. **/
+//@{
+
+//! Copies the elements of [first,last) that satisfy the predicate to result keeping their order
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator parallel_copy_if( InputIterator first, InputIterator last, OutputIterator result, Predicate pred ) {
+    predicate_selector<InputIterator, Predicate> selector{first, pred};
+    return result + do_parallel_compaction</*IsMove=*/false>(first, std::size_t(last - first), result, selector);
+}
+
+//! Copies the elements of [first,last) that are not equal to the preceding one to result
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+OutputIterator parallel_unique_copy( InputIterator first, InputIterator last, OutputIterator result,
+                                     BinaryPredicate pred )
+{
+    unique_selector<InputIterator, BinaryPredicate> selector{first, pred};
+    return result + do_parallel_compaction</*IsMove=*/false>(first, std::size_t(last - first), result, selector);
+}
+
+//! Copies the elements of [first,last) that are not equal to the preceding one to result using \c std::equal_to
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator>
+OutputIterator parallel_unique_copy( InputIterator first, InputIterator last, OutputIterator result ) {
+    return parallel_unique_copy(first, last, result,
+                                std::equal_to<typename std::iterator_traits<InputIterator>::value_type>());
+}
+
+//! Copies the elements of [first,last) that satisfy the predicate to result_true and the other ones to result_false
+/** Both parts keep the order of the elements.
+    @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+std::pair<OutputIterator1, OutputIterator2>
+parallel_partition_copy( InputIterator first, InputIterator last, OutputIterator1 result_true,
+                         OutputIterator2 result_false, Predicate pred )
+{
+    const std::size_t size = std::size_t(last - first);
+    partition_copy_scan_body<InputIterator, OutputIterator1, OutputIterator2, Predicate> body(
+        first, result_true, result_false, pred);
+    parallel_scan(blocked_range<std::size_t>(0, size), body, auto_partitioner());
+    return std::make_pair(result_true + body.count(), result_false + (size - body.count()));
+}
+//@}
+
+/** \name parallel_partition, parallel_unique
+    In place algorithms over random access sequences. **/
+//@{
+
+//! Moves the elements of [first,last) that satisfy the predicate in front of the other ones
+/** Like std::partition, the order of the elements is not kept. Every thread partitions its blocks,
+    then the selected elements after the partition point are swapped with the other ones before it.
+    Returns the partition point.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator parallel_partition( RandomAccessIterator first, RandomAccessIterator last, Predicate pred ) {
+    constexpr std::size_t min_block_size = 16 * 1024;
+    const std::size_t size = std::size_t(last - first);
+    const std::size_t num_blocks = algorithm_num_pieces(size, min_block_size);
+    if( num_blocks == 1 ) {
+        return std::partition(first, last, pred);
+    }
+    const std::size_t block_size = (size + num_blocks - 1) / num_blocks;
+
+    std::vector<std::size_t> counts(num_blocks);
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 partition_block_body<RandomAccessIterator, Predicate>(first, size, block_size, counts.data(), pred),
+                 static_partitioner());
+
+    std::size_t partition_point = 0;
+    for( std::size_t count : counts ) {
+        partition_point += count;
+    }
+
+    // Collect the rejected elements before the partition point and the selected ones after it
+    std::vector<partition_interval> rejected, selected;
+    std::size_t num_rejected = 0, num_selected = 0;
+    for( std::size_t b = 0; b < num_blocks; ++b ) {
+        const std::size_t block_begin = b * block_size;
+        const std::size_t block_end = (std::min)(size, block_begin + block_size);
+        const std::size_t block_middle = block_begin + counts[b];
+        if( block_middle < (std::min)(block_end, partition_point) ) {
+            rejected.push_back(partition_interval{block_middle, (std::min)(block_end, partition_point), num_rejected});
+            num_rejected += rejected.back().end - rejected.back().begin;
+        }
+        if( (std::max)(block_begin, partition_point) < block_middle ) {
+            selected.push_back(partition_interval{(std::max)(block_begin, partition_point), block_middle, num_selected});
+            num_selected += selected.back().end - selected.back().begin;
+        }
+    }
+    __TBB_ASSERT( num_rejected == num_selected, "The misplaced elements do not match" );
+
+    if( num_rejected != 0 ) {
+        parallel_for(blocked_range<std::size_t>(0, num_rejected, min_block_size / 4),
+                     partition_swap_body<RandomAccessIterator>(first, rejected, selected),
+                     auto_partitioner());
+    }
+    return first + partition_point;
+}
+
+//! Removes the elements of [first,last) that are equal to the preceding one; returns the new end
+/** The elements are moved through a buffer of the sequence size, so the value type shall be
+    default constructible and move assignable.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename BinaryPredicate>
+RandomAccessIterator parallel_unique( RandomAccessIterator first, RandomAccessIterator last, BinaryPredicate pred ) {
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    constexpr std::size_t min_parallel_size = 16 * 1024;
+    const std::size_t size = std::size_t(last - first);
+    if( size < min_parallel_size ) {
+        return std::unique(first, last, pred);
+    }
+    // The flags are computed before anything is moved, so each comparison sees the original elements
+    std::vector<unsigned char> flags(size);
+    parallel_for(blocked_range<std::size_t>(0, size),
+                 unique_flags_body<RandomAccessIterator, BinaryPredicate>(first, flags.data(), pred),
+                 static_partitioner());
+
+    std::vector<value_type> buffer(size);
+    flag_selector selector{flags.data()};
+    const std::size_t count = do_parallel_compaction</*IsMove=*/true>(first, size, buffer.begin(), selector);
+    parallel_for(blocked_range<std::size_t>(0, count),
+                 move_range_body<typename std::vector<value_type>::iterator, RandomAccessIterator>(buffer.begin(), first),
+                 static_partitioner());
+    return first + count;
+}
+
+//! Removes the elements of [first,last) that are equal to the preceding one using \c std::equal_to
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator>
+RandomAccessIterator parallel_unique( RandomAccessIterator first, RandomAccessIterator last ) {
+    return parallel_unique(first, last,
+                           std::equal_to<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+//@}
+
+/** \name parallel_merge, parallel_set_union, parallel_set_intersection
+    Operations on sorted random access sequences with the results of the standard algorithms.
+    The sequences are cut at the same keys into pieces that are processed in parallel. **/
+//@{
+
+//! Merges the sorted sequences into result
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+OutputIterator parallel_merge( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result, Compare comp )
+{
+    return do_parallel_sorted_operation<merge_operation, /*IsSizeKnown=*/true>(first1, last1, first2, last2, result, comp);
+}
+
+//! Merges the sorted sequences into result using \c std::less
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator parallel_merge( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result )
+{
+    return parallel_merge(first1, last1, first2, last2, result,
+                          std::less<typename std::iterator_traits<InputIterator1>::value_type>());
+}
+
+//! Writes the union of the sorted sequences to result
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+OutputIterator parallel_set_union( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                   OutputIterator result, Compare comp )
+{
+    return do_parallel_sorted_operation<set_union_operation, /*IsSizeKnown=*/false>(first1, last1, first2, last2, result, comp);
+}
+
+//! Writes the union of the sorted sequences to result using \c std::less
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator parallel_set_union( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                   OutputIterator result )
+{
+    return parallel_set_union(first1, last1, first2, last2, result,
+                              std::less<typename std::iterator_traits<InputIterator1>::value_type>());
+}
+
+//! Writes the intersection of the sorted sequences to result
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+OutputIterator parallel_set_intersection( InputIterator1 first1, InputIterator1 last1,
+                                          InputIterator2 first2, InputIterator2 last2,
+                                          OutputIterator result, Compare comp )
+{
+    return do_parallel_sorted_operation<set_intersection_operation, /*IsSizeKnown=*/false>(
+        first1, last1, first2, last2, result, comp);
+}
+
+//! Writes the intersection of the sorted sequences to result using \c std::less
+/** @ingroup algorithms **/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator parallel_set_intersection( InputIterator1 first1, InputIterator1 last1,
+                                          InputIterator2 first2, InputIterator2 last2,
+                                          OutputIterator result )
+{
+    return parallel_set_intersection(first1, last1, first2, last2, result,
+                                     std::less<typename std::iterator_traits<InputIterator1>::value_type>());
+}
+//@}
+
+} // namespace d1
+} // namespace detail
+
+inline namespace v1 {
+    using detail::d1::parallel_transform_reduce;
+    using detail::d1::parallel_copy_if;
+    using detail::d1::parallel_unique_copy;
+    using detail::d1::parallel_partition_copy;
+    using detail::d1::parallel_partition;
+    using detail::d1::parallel_unique;
+    using detail::d1::parallel_merge;
+    using detail::d1::parallel_set_union;
+    using detail::d1::parallel_set_intersection;
+} // namespace v1
+
+} // namespace tbb
+
+#endif /* __TBB_parallel_algorithms_H */
@@ -18,6 +18,10 @@
 #define __TBB_parallel_scan_H
 
 #include <functional>
+#include <iterator>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
 
 #include "detail/_config.h"
 #include "detail/_namespace_injection.h"
@@ -28,6 +32,8 @@
 #include "partitioner.h"
 #include "blocked_range.h"
 #include "task_group.h"
+#include "task_arena.h"
+#include "parallel_for.h"
 
 namespace tbb {
 namespace detail {
@@ -504,6 +510,114 @@ public:
     }
 };
 
+//! Reduces every block of the sequence except its first element into the sum of the block.
+/** The sums are initialized with the first elements of the blocks by the caller.
+    @ingroup algorithms */
+template<typename InputIterator, typename Sum, typename BinaryOperation>
+class iterator_scan_reduce_body {
+    InputIterator my_first;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    Sum* my_sums;
+    const BinaryOperation& my_op;
+
+public:
+    iterator_scan_reduce_body( InputIterator first, std::size_t size, std::size_t block_size,
+                               Sum* sums, const BinaryOperation& op )
+        : my_first(first), my_size(size), my_block_size(block_size), my_sums(sums), my_op(op) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            const std::size_t last = (std::min)(my_size, (b + 1) * my_block_size);
+            Sum sum = my_sums[b];
+            for( std::size_t i = b * my_block_size + 1; i < last; ++i ) {
+                sum = my_op(sum, my_first[i]);
+            }
+            my_sums[b] = sum;
+        }
+    }
+};
+
+//! Scans every block of the sequence starting from the sum of the preceding blocks.
+/** The element is read before the result is written, so the output may be the input itself.
+    @ingroup algorithms */
+template<typename InputIterator, typename OutputIterator, typename Sum, typename BinaryOperation, bool IsInclusive>
+class iterator_scan_final_body {
+    InputIterator my_first;
+    OutputIterator my_result;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    const Sum* my_offsets;
+    const BinaryOperation& my_op;
+
+public:
+    iterator_scan_final_body( InputIterator first, OutputIterator result, std::size_t size, std::size_t block_size,
+                              const Sum* offsets, const BinaryOperation& op )
+        : my_first(first), my_result(result), my_size(size), my_block_size(block_size)
+        , my_offsets(offsets), my_op(op) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            const std::size_t last = (std::min)(my_size, (b + 1) * my_block_size);
+            Sum sum = my_offsets[b];
+            for( std::size_t i = b * my_block_size; i < last; ++i ) {
+                if( IsInclusive ) {
+                    sum = my_op(sum, my_first[i]);
+                    my_result[i] = sum;
+                } else {
+                    Sum next = my_op(sum, my_first[i]);
+                    my_result[i] = sum;
+                    sum = next;
+                }
+            }
+        }
+    }
+};
+
+//! Computes the prefix sums of [first,first+size) starting from the given sum.
+/** The sequence is divided into one block per thread. The first pass reduces every block,
+    the sums of the blocks are scanned serially, and the second pass scans the blocks again
+    starting from the sums of the preceding ones. Both passes use static_partitioner, so a block
+    is read by the same thread both times and may still be in its cache.
+    @ingroup algorithms */
+template<bool IsInclusive, typename InputIterator, typename OutputIterator, typename Sum, typename BinaryOperation>
+void do_parallel_iterator_scan( InputIterator first, std::size_t size, OutputIterator result,
+                                Sum init, const BinaryOperation& op )
+{
+    // Smaller blocks do not pay for the second pass over the data
+    constexpr std::size_t min_block_size = 16 * 1024;
+    const std::size_t num_blocks = (std::min)(size / min_block_size, std::size_t(r1::max_concurrency(nullptr)));
+    if( num_blocks < 2 ) {
+        const Sum* offset = &init;
+        iterator_scan_final_body<InputIterator, OutputIterator, Sum, BinaryOperation, IsInclusive>(
+            first, result, size, size, offset, op)(blocked_range<std::size_t>(0, 1));
+        return;
+    }
+    const std::size_t block_size = (size + num_blocks - 1) / num_blocks;
+
+    std::vector<Sum> sums;
+    sums.reserve(num_blocks);
+    for( std::size_t b = 0; b < num_blocks; ++b ) {
+        sums.push_back(first[b * block_size]);
+    }
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 iterator_scan_reduce_body<InputIterator, Sum, BinaryOperation>(first, size, block_size, sums.data(), op),
+                 static_partitioner());
+
+    // Turn the sums of the blocks into the sums of the preceding ones
+    std::vector<Sum> offsets;
+    offsets.reserve(num_blocks);
+    offsets.push_back(init);
+    for( std::size_t b = 1; b < num_blocks; ++b ) {
+        offsets.push_back(op(offsets.back(), sums[b - 1]));
+    }
+
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 iterator_scan_final_body<InputIterator, OutputIterator, Sum, BinaryOperation, IsInclusive>(
+                     first, result, size, block_size, offsets.data(), op),
+                 static_partitioner());
+}
+
 // Requirements on Range concept are documented in blocked_range.h
 
 /** \page parallel_scan_body_req Requirements on parallel_scan body
@@ -574,11 +688,71 @@ Value parallel_scan( const Range& range, const Value& identity, const Scan& scan
     return body.result();
 }
 
+/** \name parallel_inclusive_scan, parallel_exclusive_scan
+    Prefix sums over sequences given by random access iterators, like std::inclusive_scan and
+    std::exclusive_scan. The operation shall be associative; the result may be the input itself. **/
+//@{
+
+//! Writes the inclusive prefix sums of [first,last) starting with init to result
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename BinaryOperation, typename T>
+OutputIterator parallel_inclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+                                        BinaryOperation op, T init )
+{
+    const std::size_t size = std::size_t(last - first);
+    do_parallel_iterator_scan</*IsInclusive=*/true>(first, size, result, init, op);
+    return result + size;
+}
+
+//! Writes the inclusive prefix sums of [first,last) to result
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename BinaryOperation>
+OutputIterator parallel_inclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+                                        BinaryOperation op )
+{
+    if( first == last ) {
+        return result;
+    }
+    // The first element starts the sum, so no identity is needed
+    typename std::iterator_traits<InputIterator>::value_type init = *first;
+    *result = init;
+    return parallel_inclusive_scan(first + 1, last, result + 1, op, init);
+}
+
+//! Writes the inclusive prefix sums of [first,last) to result using \c std::plus
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator>
+OutputIterator parallel_inclusive_scan( InputIterator first, InputIterator last, OutputIterator result ) {
+    return parallel_inclusive_scan(first, last, result,
+                                   std::plus<typename std::iterator_traits<InputIterator>::value_type>());
+}
+
+//! Writes the exclusive prefix sums of [first,last) starting with init to result
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename T, typename BinaryOperation>
+OutputIterator parallel_exclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+                                        T init, BinaryOperation op )
+{
+    const std::size_t size = std::size_t(last - first);
+    do_parallel_iterator_scan</*IsInclusive=*/false>(first, size, result, init, op);
+    return result + size;
+}
+
+//! Writes the exclusive prefix sums of [first,last) starting with init to result using \c std::plus
+/** @ingroup algorithms **/
+template<typename InputIterator, typename OutputIterator, typename T>
+OutputIterator parallel_exclusive_scan( InputIterator first, InputIterator last, OutputIterator result, T init ) {
+    return parallel_exclusive_scan(first, last, result, init, std::plus<T>());
+}
+//@}
+
 } // namespace d1
 } // namespace detail
 
 inline namespace v1 {
     using detail::d1::parallel_scan;
+    using detail::d1::parallel_inclusive_scan;
+    using detail::d1::parallel_exclusive_scan;
     using detail::d1::pre_scan_tag;
     using detail::d1::final_scan_tag;
 
@@ -20,12 +20,20 @@
 #include "detail/_namespace_injection.h"
 #include "parallel_for.h"
 #include "blocked_range.h"
+#include "partitioner.h"
 #include "profiling.h"
+#include "task_arena.h"
+#include "tbb_allocator.h"
 
 #include <algorithm>
 #include <iterator>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <climits>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace tbb {
 namespace detail {
@@ -185,6 +193,524 @@ void parallel_quick_sort( RandomAccessIterator begin, RandomAccessIterator end,
         do_parallel_quick_sort(begin, end, comp);
 }
 
+//! Range used by the partial sort and the selection to split elements like quick_sort_range.
+/** Only the subranges that overlap the window [first,last) of the positions that have to get
+    their sorted elements are divided further; the other ones are left as they are.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+class selection_range {
+    using base_range_type = quick_sort_range<RandomAccessIterator, Compare>;
+
+public:
+    base_range_type range;
+    RandomAccessIterator first;
+    RandomAccessIterator last;
+
+    selection_range( RandomAccessIterator begin_, std::size_t size_, const Compare& comp_,
+                     RandomAccessIterator first_, RandomAccessIterator last_ )
+        : range(begin_, size_, comp_), first(first_), last(last_) {}
+
+    selection_range( const selection_range& ) = default;
+    void operator=( const selection_range& ) = delete;
+
+    //! Checks if the range contains positions of the window
+    bool is_needed() const {
+        return range.begin < last && first < range.begin + range.size;
+    }
+
+    bool empty() const { return range.empty(); }
+    bool is_divisible() const { return range.is_divisible() && is_needed(); }
+
+    selection_range( selection_range& r, split )
+        : range(r.range, split()), first(r.first), last(r.last) {}
+};
+
+//! Body class used to put the sorted elements to the positions of the window in a subrange.
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+struct selection_body {
+    void operator()( const selection_range<RandomAccessIterator, Compare>& r ) const {
+        if( !r.is_needed() ) {
+            // Every element of the subrange is already on the right side of the window
+            return;
+        }
+        const Compare& comp = r.range.comp;
+        RandomAccessIterator begin = r.range.begin;
+        RandomAccessIterator end = begin + r.range.size;
+        RandomAccessIterator first = (std::max)(begin, r.first);
+        RandomAccessIterator last = (std::min)(end, r.last);
+
+        RandomAccessIterator sorted_begin = first;
+        if( first != begin || last - first == 1 ) {
+            std::nth_element(begin, first, end, comp);
+            ++sorted_begin;
+        }
+        if( sorted_begin < last ) {
+            if( last != end ) {
+                std::nth_element(sorted_begin, last, end, comp);
+            }
+            std::sort(sorted_begin, last, comp);
+        }
+    }
+};
+
+//! Puts the sorted elements to the positions [first,last) of [begin,end).
+/** The elements before first are not greater and the elements after last are not less than them.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+void do_parallel_selection( RandomAccessIterator begin, RandomAccessIterator end,
+                            RandomAccessIterator first, RandomAccessIterator last, const Compare& comp )
+{
+    parallel_for(selection_range<RandomAccessIterator, Compare>(begin, end - begin, comp, first, last),
+                 selection_body<RandomAccessIterator, Compare>(),
+                 auto_partitioner());
+}
+
+//! Body class used to move the smallest elements of every block to the beginning of the block.
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+class partial_sort_block_body {
+    RandomAccessIterator my_begin;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    std::size_t my_count;
+    const Compare& my_comp;
+
+public:
+    partial_sort_block_body( RandomAccessIterator begin, std::size_t size, std::size_t block_size,
+                             std::size_t count, const Compare& comp )
+        : my_begin(begin), my_size(size), my_block_size(block_size), my_count(count), my_comp(comp) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            RandomAccessIterator block_begin = my_begin + b * my_block_size;
+            RandomAccessIterator block_end = my_begin + (std::min)(my_size, (b + 1) * my_block_size);
+            std::partial_sort(block_begin, block_begin + my_count, block_end, my_comp);
+        }
+    }
+};
+
+//! Puts the middle-begin smallest elements of [begin,end) sorted into [begin,middle) if there are few of them.
+/** Every thread finds the smallest elements of its block with the heap based std::partial_sort,
+    which scans the block once when the count is small; then the candidates of all the blocks
+    are gathered at the beginning and sorted. Returns false if the count is too large for that.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+bool try_parallel_partial_sort_by_blocks( RandomAccessIterator begin, RandomAccessIterator middle,
+                                          RandomAccessIterator end, const Compare& comp )
+{
+    // The heap stops paying off once the count is a noticeable share of the block
+    constexpr std::size_t min_block_to_count_ratio = 32;
+    const std::size_t size = std::size_t(end - begin);
+    const std::size_t count = std::size_t(middle - begin);
+    const std::size_t num_blocks = std::size_t(r1::max_concurrency(nullptr));
+    const std::size_t block_size = (size + num_blocks - 1) / num_blocks;
+    // The candidates are gathered into the tail of the first block
+    if( count * num_blocks * min_block_to_count_ratio > size / num_blocks ) {
+        return false;
+    }
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 partial_sort_block_body<RandomAccessIterator, Compare>(begin, size, block_size, count, comp),
+                 static_partitioner());
+    for( std::size_t b = 1; b < num_blocks; ++b ) {
+        RandomAccessIterator block_begin = begin + b * block_size;
+        std::swap_ranges(block_begin, block_begin + count, begin + b * count);
+    }
+    std::partial_sort(begin, middle, begin + num_blocks * count, comp);
+    return true;
+}
+
+//! Maps the keys of an arithmetic type to unsigned integers with the same order
+/** Unsigned integers are used as is, the sign bit of signed integers is flipped,
+    and the negative floating point values have all their bits flipped.
+    @ingroup algorithms */
+template<typename Key, bool = std::is_floating_point<Key>::value, bool = std::is_signed<Key>::value>
+struct radix_key_traits {
+    using unsigned_type = typename std::make_unsigned<Key>::type;
+    static unsigned_type to_unsigned( Key key ) {
+        return unsigned_type(key);
+    }
+};
+
+template<typename Key>
+struct radix_key_traits<Key, /*is_floating_point=*/false, /*is_signed=*/true> {
+    using unsigned_type = typename std::make_unsigned<Key>::type;
+    static unsigned_type to_unsigned( Key key ) {
+        return unsigned_type(key) ^ (unsigned_type(1) << (sizeof(Key) * CHAR_BIT - 1));
+    }
+};
+
+template<typename Key>
+struct radix_key_traits<Key, /*is_floating_point=*/true, /*is_signed=*/true> {
+    using unsigned_type = typename std::conditional<sizeof(Key) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>::type;
+    static unsigned_type to_unsigned( Key key ) {
+        unsigned_type bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+        const unsigned_type sign_bit = unsigned_type(1) << (sizeof(Key) * CHAR_BIT - 1);
+        return (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+    }
+};
+
+//! Checks if the keys of the type can be sorted by digits
+template<typename Key>
+struct is_radix_sortable_key : std::integral_constant<bool,
+    (std::is_integral<Key>::value && !std::is_same<Key, bool>::value) ||
+    std::is_same<Key, float>::value || std::is_same<Key, double>::value> {};
+
+//! Key extractor of parallel_radix_sort that uses the elements as keys
+template<typename T>
+struct radix_identity_key {
+    T operator()( const T& value ) const { return value; }
+};
+
+//! The number of bits of a key sorted by one pass of the radix sort
+constexpr unsigned radix_sort_digit_bits = 8;
+//! The number of buckets of a radix sort pass
+constexpr std::size_t radix_sort_num_buckets = std::size_t(1) << radix_sort_digit_bits;
+
+//! Counts the digits of the keys in each block of the sequence.
+/** Every block has its own histogram, so the blocks are processed without synchronization.
+    @ingroup algorithms */
+template<typename Iterator, typename KeyExtractor>
+class radix_sort_histogram_body {
+    using key_type = typename std::decay<decltype(std::declval<const KeyExtractor&>()(*std::declval<Iterator>()))>::type;
+    using key_traits = radix_key_traits<key_type>;
+
+    Iterator my_source;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    unsigned my_shift;
+    std::size_t* my_histograms;
+    const KeyExtractor& my_key;
+
+public:
+    radix_sort_histogram_body( Iterator source, std::size_t size, std::size_t block_size, unsigned shift,
+                               std::size_t* histograms, const KeyExtractor& key )
+        : my_source(source), my_size(size), my_block_size(block_size), my_shift(shift)
+        , my_histograms(histograms), my_key(key) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            std::size_t* histogram = my_histograms + b * radix_sort_num_buckets;
+            std::fill(histogram, histogram + radix_sort_num_buckets, std::size_t(0));
+            const std::size_t last = (std::min)(my_size, (b + 1) * my_block_size);
+            for( std::size_t i = b * my_block_size; i < last; ++i ) {
+                ++histogram[(key_traits::to_unsigned(my_key(my_source[i])) >> my_shift) & (radix_sort_num_buckets - 1)];
+            }
+        }
+    }
+};
+
+//! Moves the elements of each block to the positions given by the block histogram.
+/** The elements with equal digits keep their relative order, so every pass is stable.
+    @ingroup algorithms */
+template<typename SourceIterator, typename DestinationIterator, typename KeyExtractor>
+class radix_sort_scatter_body {
+    using key_type = typename std::decay<decltype(std::declval<const KeyExtractor&>()(*std::declval<SourceIterator>()))>::type;
+    using key_traits = radix_key_traits<key_type>;
+
+    SourceIterator my_source;
+    DestinationIterator my_destination;
+    std::size_t my_size;
+    std::size_t my_block_size;
+    unsigned my_shift;
+    std::size_t* my_offsets;
+    const KeyExtractor& my_key;
+
+public:
+    radix_sort_scatter_body( SourceIterator source, DestinationIterator destination, std::size_t size,
+                             std::size_t block_size, unsigned shift, std::size_t* offsets, const KeyExtractor& key )
+        : my_source(source), my_destination(destination), my_size(size), my_block_size(block_size)
+        , my_shift(shift), my_offsets(offsets), my_key(key) {}
+
+    void operator()( const blocked_range<std::size_t>& blocks ) const {
+        for( std::size_t b = blocks.begin(); b != blocks.end(); ++b ) {
+            std::size_t* offsets = my_offsets + b * radix_sort_num_buckets;
+            const std::size_t last = (std::min)(my_size, (b + 1) * my_block_size);
+            for( std::size_t i = b * my_block_size; i < last; ++i ) {
+                std::size_t digit = (key_traits::to_unsigned(my_key(my_source[i])) >> my_shift) & (radix_sort_num_buckets - 1);
+                my_destination[offsets[digit]++] = std::move(my_source[i]);
+            }
+        }
+    }
+};
+
+//! Moves the sorted elements from a scratch buffer back to the sequence
+/** @ingroup algorithms */
+template<typename SourceIterator, typename DestinationIterator>
+class sort_move_body {
+    SourceIterator my_source;
+    DestinationIterator my_destination;
+public:
+    sort_move_body( SourceIterator source, DestinationIterator destination )
+        : my_source(source), my_destination(destination) {}
+
+    void operator()( const blocked_range<std::size_t>& range ) const {
+        for( std::size_t i = range.begin(); i != range.end(); ++i ) {
+            my_destination[i] = std::move(my_source[i]);
+        }
+    }
+};
+
+//! Performs one pass of the radix sort from the source to the destination.
+/** Returns false if all the keys have the same digit, in which case nothing is moved.
+    @ingroup algorithms */
+template<typename SourceIterator, typename DestinationIterator, typename KeyExtractor>
+bool radix_sort_pass( SourceIterator source, DestinationIterator destination, std::size_t size,
+                      std::size_t num_blocks, std::size_t block_size, unsigned shift,
+                      std::size_t* histograms, const KeyExtractor& key )
+{
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 radix_sort_histogram_body<SourceIterator, KeyExtractor>(source, size, block_size, shift, histograms, key),
+                 static_partitioner());
+
+    // Turn the counts into the positions the blocks start writing each digit at:
+    // all the elements with a smaller digit go first, then the ones of the preceding blocks.
+    std::size_t position = 0;
+    for( std::size_t digit = 0; digit < radix_sort_num_buckets; ++digit ) {
+        std::size_t digit_start = position;
+        for( std::size_t b = 0; b < num_blocks; ++b ) {
+            std::size_t& count = histograms[b * radix_sort_num_buckets + digit];
+            std::size_t block_count = count;
+            count = position;
+            position += block_count;
+        }
+        if( position - digit_start == size ) {
+            // The pass would not change the order
+            return false;
+        }
+    }
+    __TBB_ASSERT( position == size, "The histograms do not cover the sequence" );
+
+    parallel_for(blocked_range<std::size_t>(0, num_blocks),
+                 radix_sort_scatter_body<SourceIterator, DestinationIterator, KeyExtractor>(
+                     source, destination, size, block_size, shift, histograms, key),
+                 static_partitioner());
+    return true;
+}
+
+//! Sorts the sequence with the least significant digit first radix sort.
+/** The sequence is divided into a few blocks per thread; each pass counts the digits of every block
+    into its own histogram and then scatters the blocks into a buffer of the sequence size in parallel.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename KeyExtractor>
+void do_parallel_radix_sort( RandomAccessIterator begin, RandomAccessIterator end, const KeyExtractor& key ) {
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    using key_type = typename std::decay<decltype(key(*begin))>::type;
+    static_assert(is_radix_sortable_key<key_type>::value,
+                  "The key extractor of parallel_radix_sort must return an integral or a floating point key");
+    using unsigned_key_type = typename radix_key_traits<key_type>::unsigned_type;
+
+    constexpr std::size_t min_block_size = 4096;
+    constexpr std::size_t blocks_per_thread = 4;
+    const std::size_t size = std::size_t(end - begin);
+    std::size_t num_blocks = (std::min)(size / min_block_size,
+                                        std::size_t(r1::max_concurrency(nullptr)) * blocks_per_thread);
+    num_blocks = (std::max)(num_blocks, std::size_t(1));
+    const std::size_t block_size = (size + num_blocks - 1) / num_blocks;
+
+    std::unique_ptr<value_type[]> buffer(new value_type[size]);
+    std::unique_ptr<std::size_t[]> histograms(new std::size_t[num_blocks * radix_sort_num_buckets]);
+
+    bool is_in_buffer = false;
+    for( unsigned shift = 0; shift < sizeof(unsigned_key_type) * CHAR_BIT; shift += radix_sort_digit_bits ) {
+        bool moved = is_in_buffer
+            ? radix_sort_pass(buffer.get(), begin, size, num_blocks, block_size, shift, histograms.get(), key)
+            : radix_sort_pass(begin, buffer.get(), size, num_blocks, block_size, shift, histograms.get(), key);
+        if( moved ) {
+            is_in_buffer = !is_in_buffer;
+        }
+    }
+    if( is_in_buffer ) {
+        parallel_for(blocked_range<std::size_t>(0, size),
+                     sort_move_body<value_type*, RandomAccessIterator>(buffer.get(), begin),
+                     static_partitioner());
+    }
+}
+
+//! Moves the leaves of the stable sort into the scratch buffer and sorts them there
+/** If the buffer is not constructed yet, the elements are move constructed in it.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename BufferPointer, typename Compare>
+class stable_sort_leaf_body {
+    RandomAccessIterator my_begin;
+    BufferPointer my_buffer;
+    std::size_t my_size;
+    std::size_t my_leaf_size;
+    bool my_is_raw_buffer;
+    const Compare& my_comp;
+
+public:
+    stable_sort_leaf_body( RandomAccessIterator begin, BufferPointer buffer, std::size_t size,
+                           std::size_t leaf_size, bool is_raw_buffer, const Compare& comp )
+        : my_begin(begin), my_buffer(buffer), my_size(size), my_leaf_size(leaf_size)
+        , my_is_raw_buffer(is_raw_buffer), my_comp(comp) {}
+
+    void operator()( const blocked_range<std::size_t>& leaves ) const {
+        using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        for( std::size_t leaf = leaves.begin(); leaf != leaves.end(); ++leaf ) {
+            const std::size_t first = leaf * my_leaf_size;
+            const std::size_t last = (std::min)(my_size, first + my_leaf_size);
+            if( my_is_raw_buffer ) {
+                for( std::size_t i = first; i < last; ++i ) {
+                    ::new (static_cast<void*>(&my_buffer[i])) value_type(std::move(my_begin[i]));
+                }
+            } else {
+                std::move(my_begin + first, my_begin + last, my_buffer + first);
+            }
+            std::stable_sort(my_buffer + first, my_buffer + last, my_comp);
+        }
+    }
+};
+
+//! Merges the pairs of the adjacent sorted runs of one level of the stable sort
+/** Every merge is split into pieces of the same output size. The start of a piece in both runs
+    is found with a binary search (co-ranking), so all the pieces of a level run in parallel
+    regardless of how many runs are left.
+    @ingroup algorithms */
+template<typename SourceIterator, typename DestinationIterator, typename Compare>
+class stable_sort_merge_body {
+    SourceIterator my_source;
+    DestinationIterator my_destination;
+    std::size_t my_size;
+    std::size_t my_run_size;
+    std::size_t my_piece_size;
+    std::size_t my_pieces_per_merge;
+    const Compare& my_comp;
+
+    //! Returns the number of elements of the first run among the first k elements of the merge.
+    /** The elements of the first run go first if the keys are equal, which keeps the merge stable. */
+    std::size_t co_rank( std::size_t k, SourceIterator first, std::size_t first_size,
+                         SourceIterator second, std::size_t second_size ) const {
+        std::size_t low = k > second_size ? k - second_size : 0;
+        std::size_t high = (std::min)(k, first_size);
+        while( low < high ) {
+            std::size_t middle = low + (high - low) / 2;
+            if( my_comp(second[k - middle - 1], first[middle]) ) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        return low;
+    }
+
+public:
+    stable_sort_merge_body( SourceIterator source, DestinationIterator destination, std::size_t size,
+                            std::size_t run_size, std::size_t piece_size, const Compare& comp )
+        : my_source(source), my_destination(destination), my_size(size), my_run_size(run_size)
+        , my_piece_size(piece_size), my_pieces_per_merge((2 * run_size + piece_size - 1) / piece_size)
+        , my_comp(comp) {}
+
+    std::size_t num_pieces() const {
+        std::size_t merge_size = 2 * my_run_size;
+        return (my_size + merge_size - 1) / merge_size * my_pieces_per_merge;
+    }
+
+    void operator()( const blocked_range<std::size_t>& pieces ) const {
+        for( std::size_t piece = pieces.begin(); piece != pieces.end(); ++piece ) {
+            const std::size_t merge_begin = piece / my_pieces_per_merge * 2 * my_run_size;
+            const std::size_t first_size = (std::min)(my_run_size, my_size - merge_begin);
+            const std::size_t second_size = (std::min)(my_run_size, my_size - merge_begin - first_size);
+            const std::size_t out_begin = piece % my_pieces_per_merge * my_piece_size;
+            if( out_begin >= first_size + second_size ) {
+                continue;
+            }
+            const std::size_t out_end = (std::min)(out_begin + my_piece_size, first_size + second_size);
+
+            SourceIterator first = my_source + merge_begin;
+            SourceIterator second = first + first_size;
+            std::size_t i_begin = co_rank(out_begin, first, first_size, second, second_size);
+            std::size_t i_end = co_rank(out_end, first, first_size, second, second_size);
+            std::merge(std::make_move_iterator(first + i_begin), std::make_move_iterator(first + i_end),
+                       std::make_move_iterator(second + (out_begin - i_begin)),
+                       std::make_move_iterator(second + (out_end - i_end)),
+                       my_destination + merge_begin + out_begin, my_comp);
+        }
+    }
+};
+
+//! Merges all the runs of the given size from the source to the destination
+/** @ingroup algorithms */
+template<typename SourceIterator, typename DestinationIterator, typename Compare>
+void stable_sort_merge_level( SourceIterator source, DestinationIterator destination, std::size_t size,
+                              std::size_t run_size, std::size_t piece_size, const Compare& comp )
+{
+    stable_sort_merge_body<SourceIterator, DestinationIterator, Compare> body(
+        source, destination, size, run_size, piece_size, comp);
+    parallel_for(blocked_range<std::size_t>(0, body.num_pieces()), body, static_partitioner());
+}
+
+//! Sorts the data in [begin,end) with the parallel merge sort that keeps the order of equal elements.
+/** The leaves are sorted with std::stable_sort into the buffer, then the runs are merged level by level
+    moving the data between the buffer and the sequence. The buffer holds size elements and is
+    constructed on entry if is_raw_buffer is true; the caller destroys it.
+    @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare, typename BufferPointer>
+void do_parallel_stable_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp,
+                              BufferPointer buffer, bool is_raw_buffer )
+{
+    constexpr std::size_t min_leaf_size = 2048;
+    constexpr std::size_t leaves_per_thread = 4;
+    const std::size_t size = std::size_t(end - begin);
+    const std::size_t num_threads = std::size_t(r1::max_concurrency(nullptr));
+    const std::size_t leaf_size = (std::max)(min_leaf_size, (size + num_threads * leaves_per_thread - 1) /
+                                                            (num_threads * leaves_per_thread));
+    const std::size_t num_leaves = (size + leaf_size - 1) / leaf_size;
+
+    parallel_for(blocked_range<std::size_t>(0, num_leaves),
+                 stable_sort_leaf_body<RandomAccessIterator, BufferPointer, Compare>(
+                     begin, buffer, size, leaf_size, is_raw_buffer, comp),
+                 static_partitioner());
+
+    bool is_in_buffer = true;
+    for( std::size_t run_size = leaf_size; run_size < size; run_size *= 2 ) {
+        if( is_in_buffer ) {
+            stable_sort_merge_level(buffer, begin, size, run_size, leaf_size, comp);
+        } else {
+            stable_sort_merge_level(begin, buffer, size, run_size, leaf_size, comp);
+        }
+        is_in_buffer = !is_in_buffer;
+    }
+    if( is_in_buffer ) {
+        parallel_for(blocked_range<std::size_t>(0, size),
+                     sort_move_body<BufferPointer, RandomAccessIterator>(buffer, begin),
+                     static_partitioner());
+    }
+}
+
+//! Scratch buffer of the stable sort obtained from the allocator
+/** @ingroup algorithms */
+template<typename Allocator>
+class stable_sort_buffer : no_copy {
+    using allocator_traits = std::allocator_traits<Allocator>;
+    using pointer = typename allocator_traits::pointer;
+
+    Allocator my_allocator;
+    pointer my_data;
+    std::size_t my_size;
+    bool my_is_constructed;
+
+public:
+    stable_sort_buffer( const Allocator& allocator, std::size_t size )
+        : my_allocator(allocator), my_data(allocator_traits::allocate(my_allocator, size))
+        , my_size(size), my_is_constructed(false) {}
+
+    ~stable_sort_buffer() {
+        if( my_is_constructed ) {
+            for( std::size_t i = 0; i < my_size; ++i ) {
+                allocator_traits::destroy(my_allocator, &my_data[i]);
+            }
+        }
+        allocator_traits::deallocate(my_allocator, my_data, my_size);
+    }
+
+    typename allocator_traits::value_type* data() { return &my_data[0]; }
+
+    //! Marks the elements as constructed, so the buffer destroys them
+    void set_constructed() { my_is_constructed = true; }
+};
+
 /** \page parallel_sort_iter_req Requirements on iterators for parallel_sort
     Requirements on the iterator type \c It and its value type \c T for \c parallel_sort:
 
@@ -194,6 +720,27 @@ void parallel_quick_sort( RandomAccessIterator begin, RandomAccessIterator end,
     - \code bool Compare::operator()( const T& x, const T& y ) \endcode True if x comes before y;
 **/
 
+//! Sorts the data in [begin,end) with the quick sort
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+void parallel_sort_impl( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp, std::false_type ) {
+    parallel_quick_sort(begin, end, comp);
+}
+
+//! Sorts the arithmetic data in [begin,end) ordered by std::less with the radix sort if it is large enough
+/** @ingroup algorithms */
+template<typename RandomAccessIterator, typename Compare>
+void parallel_sort_impl( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp, std::true_type ) {
+    // Below that size a few passes over the whole sequence cost more than the comparisons of the quick sort
+    constexpr std::ptrdiff_t min_radix_sort_size = 1 << 16;
+    if( end - begin < min_radix_sort_size ) {
+        parallel_quick_sort(begin, end, comp);
+    } else {
+        using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        do_parallel_radix_sort(begin, end, radix_identity_key<value_type>());
+    }
+}
+
 /** \name parallel_sort
     See also requirements on \ref parallel_sort_iter_req "iterators for parallel_sort". **/
 //@{
@@ -204,12 +751,16 @@ void parallel_quick_sort( RandomAccessIterator begin, RandomAccessIterator end,
     @ingroup algorithms **/
 template<typename RandomAccessIterator, typename Compare>
 void parallel_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp ) {
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    // The radix sort gives the same order as the default comparator for the arithmetic keys
+    using use_radix_sort = std::integral_constant<bool,
+        is_radix_sortable_key<value_type>::value && std::is_same<Compare, std::less<value_type>>::value>;
     constexpr int min_parallel_size = 500;
     if( end > begin ) {
         if( end - begin < min_parallel_size ) {
             std::sort(begin, end, comp);
         } else {
-            parallel_quick_sort(begin, end, comp);
+            parallel_sort_impl(begin, end, comp, use_radix_sort());
         }
     }
 }
@@ -236,11 +787,178 @@ void parallel_sort( Range& rng ) {
 }
 //@}
 
+/** \name parallel_radix_sort
+    Stable least significant digit first radix sort. The elements are moved to a scratch buffer
+    of the sequence size and back, so the value type shall be default constructible and move assignable. **/
+//@{
+
+//! Sorts the integral or floating point data in [begin,end) in the ascending order
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator>
+void parallel_radix_sort( RandomAccessIterator begin, RandomAccessIterator end ) {
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    parallel_radix_sort(begin, end, radix_identity_key<value_type>());
+}
+
+//! Sorts the data in [begin,end) in the ascending order of the integral or floating point keys
+/** The key extractor is called with an element and returns its key; it is called several times
+    for every element, so it should be cheap. The elements with equal keys keep their relative order.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename KeyExtractor>
+void parallel_radix_sort( RandomAccessIterator begin, RandomAccessIterator end, const KeyExtractor& key ) {
+    if( end - begin > 1 ) {
+        do_parallel_radix_sort(begin, end, key);
+    }
+}
+//@}
+
+/** \name parallel_stable_sort
+    Parallel merge sort that keeps the relative order of equal elements. It needs a scratch buffer
+    of the sequence size; by default it is taken from tbb_allocator, which uses the scalable
+    allocator when it is available. **/
+//@{
+
+//! Sorts the data in [begin,end) using the given comparator and the scratch buffer from the allocator
+/** The allocator is rebound to the value type of the iterator.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Compare, typename Allocator,
+         typename = typename std::enable_if<!std::is_pointer<Allocator>::value>::type>
+void parallel_stable_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp,
+                           const Allocator& allocator )
+{
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    using buffer_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    constexpr int min_parallel_size = 500;
+    if( end > begin ) {
+        if( end - begin < min_parallel_size ) {
+            std::stable_sort(begin, end, comp);
+        } else {
+            stable_sort_buffer<buffer_allocator_type> buffer(buffer_allocator_type(allocator), std::size_t(end - begin));
+            do_parallel_stable_sort(begin, end, comp, buffer.data(), /*is_raw_buffer=*/true);
+            buffer.set_constructed();
+        }
+    }
+}
+
+//! Sorts the data in [begin,end) using the given comparator and the caller provided scratch buffer
+/** The buffer shall hold end-begin constructed elements; their values are unspecified afterwards.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Compare>
+void parallel_stable_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp,
+                           typename std::iterator_traits<RandomAccessIterator>::value_type* buffer )
+{
+    constexpr int min_parallel_size = 500;
+    if( end > begin ) {
+        if( end - begin < min_parallel_size ) {
+            std::stable_sort(begin, end, comp);
+        } else {
+            do_parallel_stable_sort(begin, end, comp, buffer, /*is_raw_buffer=*/false);
+        }
+    }
+}
+
+//! Sorts the data in [begin,end) using the given comparator
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Compare>
+void parallel_stable_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp ) {
+    using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    parallel_stable_sort(begin, end, comp, tbb_allocator<value_type>());
+}
+
+//! Sorts the data in [begin,end) with a default comparator \c std::less<RandomAccessIterator>
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator>
+void parallel_stable_sort( RandomAccessIterator begin, RandomAccessIterator end ) {
+    parallel_stable_sort(begin, end, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+//! Sorts the data in rng using the given comparator
+/** @ingroup algorithms **/
+template<typename Range, typename Compare>
+void parallel_stable_sort( Range& rng, const Compare& comp ) {
+    parallel_stable_sort(std::begin(rng), std::end(rng), comp);
+}
+
+//! Sorts the data in rng with a default comparator \c std::less<RandomAccessIterator>
+/** @ingroup algorithms **/
+template<typename Range>
+void parallel_stable_sort( Range& rng ) {
+    parallel_stable_sort(std::begin(rng), std::end(rng));
+}
+//@}
+
+/** \name parallel_partial_sort
+    Picks the smallest elements of every block in parallel if only a few are requested; otherwise
+    partitions the data like parallel_sort does, but splits further only the subranges
+    that have the first elements of the sorted order. **/
+//@{
+
+//! Puts the middle-begin smallest elements of [begin,end) sorted into [begin,middle)
+/** The order of the elements in [middle,end) is unspecified.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Compare>
+void parallel_partial_sort( RandomAccessIterator begin, RandomAccessIterator middle, RandomAccessIterator end,
+                            const Compare& comp )
+{
+    constexpr int min_parallel_size = 500;
+    if( middle > begin ) {
+        if( end - begin < min_parallel_size ) {
+            std::partial_sort(begin, middle, end, comp);
+        } else if( !try_parallel_partial_sort_by_blocks(begin, middle, end, comp) ) {
+            do_parallel_selection(begin, end, begin, middle, comp);
+        }
+    }
+}
+
+//! Puts the middle-begin smallest elements of [begin,end) sorted into [begin,middle) with \c std::less
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator>
+void parallel_partial_sort( RandomAccessIterator begin, RandomAccessIterator middle, RandomAccessIterator end ) {
+    parallel_partial_sort(begin, middle, end,
+                          std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+//@}
+
+/** \name parallel_nth_element
+    Partitions the data like parallel_sort does, but splits further only the subranges
+    that have the nth position. **/
+//@{
+
+//! Puts to nth the element that would be there if [begin,end) were sorted
+/** No element of [begin,nth) is greater and no element of (nth,end) is less than it.
+    @ingroup algorithms **/
+template<typename RandomAccessIterator, typename Compare>
+void parallel_nth_element( RandomAccessIterator begin, RandomAccessIterator nth, RandomAccessIterator end,
+                           const Compare& comp )
+{
+    constexpr int min_parallel_size = 500;
+    if( end > nth ) {
+        if( end - begin < min_parallel_size ) {
+            std::nth_element(begin, nth, end, comp);
+        } else {
+            do_parallel_selection(begin, end, nth, nth + 1, comp);
+        }
+    }
+}
+
+//! Puts to nth the element that would be there if [begin,end) were sorted with \c std::less
+/** @ingroup algorithms **/
+template<typename RandomAccessIterator>
+void parallel_nth_element( RandomAccessIterator begin, RandomAccessIterator nth, RandomAccessIterator end ) {
+    parallel_nth_element(begin, nth, end,
+                         std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+//@}
+
 } // namespace d1
 } // namespace detail
 
 inline namespace v1 {
     using detail::d1::parallel_sort;
+    using detail::d1::parallel_radix_sort;
+    using detail::d1::parallel_stable_sort;
+    using detail::d1::parallel_partial_sort;
+    using detail::d1::parallel_nth_element;
 } // namespace v1
 } // namespace tbb
 
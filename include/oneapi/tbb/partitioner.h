@@ -263,6 +263,11 @@ struct partition_type_base {
     template <typename Range> split_type get_split() { return split(); }
     Partition& self() { return *static_cast<Partition*>(this); } // CRTP helper
 
+    //! Lives while the initial divisions spread the work; the tasks are spawned one by one by default
+    struct work_spreading_scope {
+        explicit work_spreading_scope(Partition&) {}
+    };
+
     template<typename StartType, typename Range>
     void work_balance(StartType &start, Range &range, const execution_data&) {
         start.run_body( range ); // simple partitioner goes always here
@@ -279,6 +284,7 @@ struct partition_type_base {
         // If not divisible or [max depth is reached], execute, else do the range pool part
         if ( range.is_divisible() ) {
             if ( self().is_divisible() ) {
+                typename Partition::work_spreading_scope spreading_scope(self());
                 do { // split until is divisible
                     typename Partition::split_type split_obj = self().template get_split<Range>();
                     start.offer_work( split_obj, ed );
@@ -535,6 +541,40 @@ class affinity_partition_type : public dynamic_grainsize_mode<linear_affinity_mo
     static const unsigned factor_power = 4; // TODO: get a unified formula based on number of computing units
     slot_id* my_array;
 public:
+    //! Collects the tasks created by the initial divisions to mail them to their slots at once
+    /** The tasks are published to the local task pool as soon as they are created, so they
+        can be stolen right away; only the mailing is postponed until the scope ends or the
+        buffer fills up, so each slot receives the subranges recorded for it by a single push
+        to its mailbox. **/
+    class work_spreading_scope : no_copy {
+        static constexpr std::size_t max_size = 16;
+        affinity_partition_type& my_partition;
+        task* my_proxies[max_size];
+        std::size_t my_size{0};
+    public:
+        explicit work_spreading_scope(affinity_partition_type& p) : my_partition(p) {
+            my_partition.my_spreading_scope = this;
+        }
+        ~work_spreading_scope() {
+            my_partition.my_spreading_scope = nullptr;
+            flush();
+        }
+        void spawn(task& t, task_group_context& ctx, slot_id id) {
+            if (task* proxy = spawn_deferred_mail(t, ctx, id)) {
+                if (my_size == max_size) {
+                    flush();
+                }
+                my_proxies[my_size++] = proxy;
+            }
+        }
+        void flush() {
+            if (my_size) {
+                mail_proxies(my_proxies, my_size);
+                my_size = 0;
+            }
+        }
+    };
+
     static const unsigned factor = 1 << factor_power; // number of slots in affinity array per task
     typedef detail::proportional_split split_type;
     affinity_partition_type( affinity_partitioner_base& ap )
@@ -547,26 +587,35 @@ public:
     }
     affinity_partition_type(affinity_partition_type& p, split)
         : dynamic_grainsize_mode<linear_affinity_mode<affinity_partition_type> >(p, split())
-        , my_array(p.my_array) {}
+        , my_array(p.my_array), my_spreading_scope(p.my_spreading_scope) {}
     affinity_partition_type(affinity_partition_type& p, const proportional_split& split_obj)
         : dynamic_grainsize_mode<linear_affinity_mode<affinity_partition_type> >(p, split_obj)
-        , my_array(p.my_array) {}
+        , my_array(p.my_array), my_spreading_scope(p.my_spreading_scope) {}
     void note_affinity(slot_id id) {
         if( my_divisor )
             my_array[my_head] = id;
     }
     void spawn_task(task& t, task_group_context& ctx) {
+        slot_id id = no_slot;
         if (my_divisor) {
-            if (!my_array[my_head]) {
-                // TODO: consider new ideas with my_array for both affinity and static partitioner's, then code reuse
-                spawn(t, ctx, slot_id(my_head / factor));
-            } else {
-                spawn(t, ctx, my_array[my_head]);
-            }
+            // TODO: consider new ideas with my_array for both affinity and static partitioner's, then code reuse
+            id = !my_array[my_head] ? slot_id(my_head / factor) : my_array[my_head];
+        }
+        // The scope of the spreading parent must not be used once this task is spawned
+        work_spreading_scope* scope = my_spreading_scope;
+        my_spreading_scope = nullptr;
+        if (scope && id != no_slot) {
+            // The parent mails the task when it stops spreading the work
+            scope->spawn(t, ctx, id);
+        } else if (id != no_slot) {
+            spawn(t, ctx, id);
         } else {
             spawn(t, ctx);
         }
     }
+private:
+    //! Set while the partition spreads the work, and inherited by the tasks created meanwhile
+    work_spreading_scope* my_spreading_scope{nullptr};
 };
 
 //! A simple partitioner
@@ -87,6 +87,8 @@ namespace r1 {
     void __TBB_EXPORTED_FUNC itt_region_begin(d1::itt_domain_enum domain, void* region, unsigned long long region_extra,
         void* parent, unsigned long long parent_extra, string_resource_index /* name_index */);
     void __TBB_EXPORTED_FUNC itt_region_end(d1::itt_domain_enum domain, void* region, unsigned long long region_extra);
+    bool __TBB_EXPORTED_FUNC write_scheduler_trace(const char* file_name);
+    void __TBB_EXPORTED_FUNC clear_scheduler_trace();
 } // namespace r1
 
 namespace d1 {
@@ -231,11 +233,27 @@ struct event {
     static void emit(const std::string &) { }
 };
 #endif // TBB_USE_PROFILING_TOOLS && !(TBB_USE_PROFILING_TOOLS == 2)
+
+//! Writes the scheduler events recorded by the library to the file in the Chrome trace event format
+/** The file can be opened with chrome://tracing or Perfetto UI. The events are recorded only if
+    the library is built with the scheduler trace enabled (TBB_SCHEDULER_TRACE build option);
+    otherwise the function returns false. Each thread keeps a limited number of its latest events.
+    Returns false if the file cannot be written. **/
+inline bool write_scheduler_trace(const char* file_name) {
+    return r1::write_scheduler_trace(file_name);
+}
+
+//! Drops the scheduler events recorded so far from the subsequently written traces
+inline void clear_scheduler_trace() {
+    r1::clear_scheduler_trace();
+}
 } // namespace d1
 } // namespace detail
 
 namespace profiling {
     using detail::d1::event;
+    using detail::d1::write_scheduler_trace;
+    using detail::d1::clear_scheduler_trace;
 }
 } // namespace tbb
 
@@ -28,6 +28,8 @@ namespace task {
     using detail::d1::suspend_point;
     using detail::d1::resume;
     using detail::d1::suspend;
+    using detail::d1::coroutine_stack_statistics;
+    using detail::d1::query_coroutine_stack_statistics;
 #endif /* __TBB_RESUMABLE_TASKS */
     using detail::d1::current_context;
 } // namespace task
@@ -27,6 +27,8 @@
 #include "info.h"
 #endif /*__TBB_NUMA_SUPPORT*/
 
+#include <chrono>
+
 namespace tbb {
 namespace detail {
 
@@ -72,6 +74,31 @@ public:
 
 class task_arena_base;
 class task_scheduler_observer;
+
+//! Scheduler activity counters of a task arena
+/** The per-slot counters are gathered only if the library is built with scheduler statistics enabled
+    (TBB_STATISTICS build option); otherwise they stay zero. The arena-wide counters at the end of
+    the structure are maintained in any configuration. **/
+struct arena_statistics {
+    //! Number of tasks spawned into the local task pools of the arena slots
+    std::uint64_t tasks_spawned{0};
+    //! Number of tasks executed by the threads joined the arena
+    std::uint64_t tasks_executed{0};
+    //! Number of tasks successfully stolen from other arena slots
+    std::uint64_t tasks_stolen{0};
+    //! Number of steal attempts that did not yield a task
+    std::uint64_t failed_steal_attempts{0};
+    //! Number of tasks taken from the affinity mailboxes
+    std::uint64_t mailbox_hits{0};
+    //! Number of task proxies freed after their task was taken by another thread
+    std::uint64_t proxies_dropped{0};
+    //! Time in nanoseconds spent by the worker threads pausing in the stealing loop
+    std::uint64_t worker_pause_time_ns{0};
+    //! Number of execute calls that found no free slot and waited for the functor to be run by the arena
+    std::uint64_t delegated_executions{0};
+    //! Number of tasks enqueued with a deadline that were taken for execution after the deadline
+    std::uint64_t missed_deadlines{0};
+};
 } // namespace d1
 
 namespace r1 {
@@ -86,8 +113,10 @@ void __TBB_EXPORTED_FUNC execute(d1::task_arena_base&, d1::delegate_base&);
 void __TBB_EXPORTED_FUNC wait(d1::task_arena_base&);
 int __TBB_EXPORTED_FUNC max_concurrency(const d1::task_arena_base*);
 void __TBB_EXPORTED_FUNC isolate_within_arena(d1::delegate_base& d, std::intptr_t);
+bool __TBB_EXPORTED_FUNC query_statistics(const d1::task_arena_base&, d1::arena_statistics&);
 
 void __TBB_EXPORTED_FUNC enqueue(d1::task&, d1::task_arena_base*);
+void __TBB_EXPORTED_FUNC enqueue(d1::task&, d1::task_arena_base*, std::int64_t);
 void __TBB_EXPORTED_FUNC submit(d1::task&, d1::task_group_context&, arena*, std::uintptr_t);
 } // namespace r1
 
@@ -105,6 +134,16 @@ public:
         high   = 3 * priority_stride
     };
 #if __TBB_NUMA_SUPPORT
+    //! How the threads of the arena are pinned to the cores
+    enum class thread_pinning : int {
+        //! The threads are not pinned to the cores
+        none,
+        //! The slot i is pinned to the i-th core, so the neighbour slots share the caches
+        compact,
+        //! The neighbour slots are pinned to the cores of the different packages first
+        scatter
+    };
+
     // TODO: consider version approach to resolve backward compatibility potential issues.
     struct constraints {
         constraints(numa_node_id id = automatic, int maximal_concurrency = automatic)
@@ -113,6 +152,11 @@ public:
         {}
         numa_node_id numa_id;
         int max_concurrency;
+        //! Prefer victims on the same NUMA node as the thief when stealing
+        bool numa_aware_stealing{false};
+        //! Pin each slot of the arena to a core of the NUMA node, or of the process if numa_id is automatic
+        /** The threads get back their previous affinity when they leave the arena. **/
+        thread_pinning pinning{thread_pinning::none};
     };
 #endif /*__TBB_NUMA_SUPPORT*/
 protected:
@@ -138,7 +182,12 @@ protected:
     numa_node_id my_numa_id;
 #endif
 
-    enum { default_flags = 0 };
+    enum {
+        default_flags = 0,
+        numa_aware_stealing_flag = 1,
+        compact_pinning_flag = 2,
+        scatter_pinning_flag = 4
+    };
 
     task_arena_base(int max_concurrency, unsigned reserved_for_masters, priority a_priority)
         :
@@ -153,7 +202,7 @@ protected:
 
 #if __TBB_NUMA_SUPPORT
     task_arena_base(const constraints& constraints_, unsigned reserved_for_masters, priority a_priority)
-        : my_version_and_traits(default_flags)
+        : my_version_and_traits(traits_of(constraints_))
         , my_initialization_state(do_once_state::uninitialized)
         , my_arena(nullptr)
         , my_max_concurrency(constraints_.max_concurrency)
@@ -161,6 +210,16 @@ protected:
         , my_priority(a_priority)
         , my_numa_id(constraints_.numa_id )
         {}
+
+    static intptr_t traits_of(const constraints& constraints_) {
+        intptr_t traits = constraints_.numa_aware_stealing ? numa_aware_stealing_flag : default_flags;
+        if (constraints_.pinning == thread_pinning::compact) {
+            traits |= compact_pinning_flag;
+        } else if (constraints_.pinning == thread_pinning::scatter) {
+            traits |= scatter_pinning_flag;
+        }
+        return traits;
+    }
 #endif /*__TBB_NUMA_SUPPORT*/
 public:
     //! Typedef for number of threads that is automatic.
@@ -216,6 +275,14 @@ class task_arena : public task_arena_base {
         r1::enqueue(*alloc.new_object<enqueue_task<typename std::decay<F>::type>>(std::forward<F>(f), alloc), this);
     }
 
+    template<typename F>
+    void enqueue_impl(F&& f, std::chrono::steady_clock::time_point deadline) {
+        initialize();
+        small_object_allocator alloc{};
+        std::int64_t deadline_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        r1::enqueue(*alloc.new_object<enqueue_task<typename std::decay<F>::type>>(std::forward<F>(f), alloc), this, deadline_ns);
+    }
+
     template<typename R, typename F>
     R execute_impl(F& f) {
         initialize();
@@ -247,7 +314,9 @@ public:
         : task_arena_base(
             constraints(s.my_numa_id, s.my_max_concurrency), s.my_master_slots, s.my_priority
         )
-    {}
+    {
+        my_version_and_traits = s.my_version_and_traits;
+    }
 #else
     //! Copies settings from another task_arena
     task_arena(const task_arena& a) // copy settings but not the reference or instance
@@ -294,6 +363,7 @@ public:
         if( !is_active() ) {
             my_numa_id = constraints_.numa_id;
             my_max_concurrency = constraints_.max_concurrency;
+            my_version_and_traits = traits_of(constraints_);
             my_master_slots = reserved_for_masters;
             my_priority = a_priority;
             r1::initialize(*this);
@@ -343,6 +413,14 @@ public:
         enqueue_impl(std::forward<F>(f));
     }
 
+    //! Enqueues a task into the arena to process a functor by the given deadline, and immediately returns.
+    //! The tasks with deadlines are taken in the earliest-deadline-first order ahead of the other enqueued tasks.
+    //! A task taken for execution after its deadline is still executed and counted in arena_statistics::missed_deadlines.
+    template<typename F>
+    void enqueue(F&& f, std::chrono::steady_clock::time_point deadline) {
+        enqueue_impl(std::forward<F>(f), deadline);
+    }
+
     //! Joins the arena and executes a mutable functor, then returns
     //! If not possible to join, wraps the functor into a task, enqueues it and waits for task completion
     //! Can decrement the arena demand for workers, causing a worker to leave and free a slot to the calling thread
@@ -380,6 +458,14 @@ public:
         return (my_max_concurrency > 1) ? my_max_concurrency : r1::max_concurrency(this);
     }
 
+    //! Fills the scheduler activity counters accumulated by the arena since its initialization
+    /** Returns false if the arena is not initialized or the library does not gather statistics.
+        The arena-wide counters are filled for an initialized arena in either case. **/
+    bool query_statistics(arena_statistics& stats) const {
+        stats = arena_statistics{};
+        return is_active() && r1::query_statistics(*this, stats);
+    }
+
     friend void submit(task& t, task_arena& ta, task_group_context& ctx, bool as_critical) {
         __TBB_ASSERT(ta.is_active(), nullptr);
         call_itt_task_notify(releasing, &t);
@@ -412,6 +498,7 @@ using r1::submit;
 
 inline namespace v1 {
 using detail::d1::task_arena;
+using detail::d1::arena_statistics;
 
 namespace this_task_arena {
 using detail::d1::current_thread_index;
@@ -0,0 +1,256 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_task_coroutine_H
+#define __TBB_task_coroutine_H
+
+#include "detail/_config.h"
+#include "detail/_namespace_injection.h"
+#include "detail/_task.h"
+#include "detail/_small_object_pool.h"
+
+#include "task_arena.h"
+#include "task_group.h"
+
+#if __TBB_CPP20_COROUTINES_PRESENT
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace tbb {
+namespace detail {
+namespace d1 {
+
+//! State of a coroutine suspended by co_await suspend_coroutine(...)
+/** Lives in the coroutine frame while the coroutine is suspended, so no stack and no other
+    memory is kept for a suspended coroutine. **/
+struct coroutine_suspend_point_type : no_copy {
+    std::coroutine_handle<> m_handle{};
+    //! Where the coroutine_task promise stores the escaped exception, nullptr for other coroutines
+    std::exception_ptr** m_exception_slot{nullptr};
+    //! The group that waits for the coroutine, or nullptr if the coroutine is resumed as an enqueued task
+    wait_context* m_wait_ctx{nullptr};
+    task_group_context* m_context{nullptr};
+    task_arena* m_arena{nullptr};
+    //! The arena of the group task that awaits
+    std::optional<task_arena> m_attached_arena;
+
+    explicit coroutine_suspend_point_type(task_group_base& g)
+        : m_wait_ctx(&g.m_wait_ctx), m_context(&g.m_context)
+    {
+        m_attached_arena.emplace(task_arena::attach{});
+        m_arena = &*m_attached_arena;
+    }
+
+    explicit coroutine_suspend_point_type(task_arena& a) : m_arena(&a) {}
+};
+
+using coroutine_suspend_point = coroutine_suspend_point_type*;
+
+//! Return type of the coroutines executed as tasks
+/** @ingroup task_scheduling
+    The coroutine does not start when it is called. The returned object is a function object that
+    runs the coroutine until its first suspension, so it can be passed to task_group::run or
+    task_arena::enqueue. The frame is destroyed when the coroutine finishes. **/
+class coroutine_task {
+public:
+    class promise_type {
+        //! Set by the thread that resumes the coroutine to receive the escaped exception
+        std::exception_ptr* m_exception_slot{nullptr};
+        friend class coroutine_task;
+        template <typename F> friend class coroutine_suspender;
+    public:
+        coroutine_task get_return_object() noexcept {
+            return coroutine_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept {
+            __TBB_ASSERT(m_exception_slot, "The coroutine is not resumed by coroutine_task or resume");
+            *m_exception_slot = std::current_exception();
+        }
+    };
+
+    coroutine_task(coroutine_task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    coroutine_task& operator=(coroutine_task&& other) noexcept {
+        if (this != &other) {
+            coroutine_task(std::move(other)).swap(*this);
+        }
+        return *this;
+    }
+
+    ~coroutine_task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    void swap(coroutine_task& other) noexcept {
+        std::swap(m_handle, other.m_handle);
+    }
+
+    //! Runs the coroutine until it is suspended or finished
+    /** Can be called once; the exception escaped from the coroutine is rethrown. **/
+    void operator()() const {
+        __TBB_ASSERT(m_handle, "The coroutine has already been started");
+        std::exception_ptr exception;
+        std::coroutine_handle<promise_type> h = std::exchange(m_handle, nullptr);
+        h.promise().m_exception_slot = &exception;
+        // After this point the frame can be destroyed at any moment
+        h.resume();
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    explicit coroutine_task(std::coroutine_handle<promise_type> h) noexcept : m_handle(h) {}
+
+    // The handle is released by the const call operator because task_group::run keeps the functor as const
+    mutable std::coroutine_handle<promise_type> m_handle;
+};
+
+//! The task that continues the suspended coroutine
+class coroutine_resume_task : public task {
+    std::coroutine_handle<> m_handle;
+    std::exception_ptr** m_exception_slot;
+    wait_context* m_wait_ctx;
+    small_object_allocator m_allocator;
+    bool m_is_resumed{false};
+
+    template <typename... ExecutionData>
+    void finalize(ExecutionData&... ed) {
+        wait_context* wo = m_wait_ctx;
+        auto allocator = m_allocator;
+        this->~coroutine_resume_task();
+        allocator.deallocate(this, ed...);
+        if (wo) {
+            wo->release();
+        }
+    }
+    task* execute(execution_data& ed) override {
+        std::exception_ptr exception;
+        if (m_exception_slot) {
+            *m_exception_slot = &exception;
+        }
+        m_is_resumed = true;
+        // The frame, including the suspend point, can be destroyed before resume returns
+        m_handle.resume();
+        if (exception) {
+            // The scheduler cancels the group, keeps the exception, and calls cancel for this task
+            std::rethrow_exception(exception);
+        }
+        finalize(ed);
+        return nullptr;
+    }
+    task* cancel(execution_data& ed) override {
+        __TBB_ASSERT_RELEASE(m_wait_ctx || !m_is_resumed, "Unhandled exception from the coroutine is caught");
+        if (!m_is_resumed) {
+            // The group has been cancelled while the coroutine was suspended, so the rest of it is skipped
+            m_handle.destroy();
+        }
+        finalize(ed);
+        return nullptr;
+    }
+public:
+    coroutine_resume_task(const coroutine_suspend_point_type& sp, small_object_allocator& alloc)
+        : m_handle(sp.m_handle), m_exception_slot(sp.m_exception_slot), m_wait_ctx(sp.m_wait_ctx), m_allocator(alloc) {}
+};
+
+//! Awaitable that suspends the coroutine and passes its suspend point to the callback
+template <typename F>
+class coroutine_suspender : coroutine_suspend_point_type {
+    F m_callback;
+public:
+    template <typename Owner, typename Callback>
+    coroutine_suspender(Owner& owner, Callback&& callback)
+        : coroutine_suspend_point_type(owner), m_callback(std::forward<Callback>(callback)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) {
+        m_handle = h;
+        if constexpr (std::is_same<Promise, coroutine_task::promise_type>::value) {
+            m_exception_slot = &h.promise().m_exception_slot;
+        }
+        if (m_wait_ctx) {
+            __TBB_ASSERT(m_arena->is_active(), "The coroutine must be suspended by a task running in an arena");
+            // The group waits for the coroutine while it is suspended
+            m_wait_ctx->reserve();
+        } else {
+            m_arena->initialize();
+        }
+        // Move the callback out of the frame because the coroutine can be resumed and the frame
+        // destroyed while the callback is being called.
+        F callback = std::move(m_callback);
+        callback(static_cast<coroutine_suspend_point>(this));
+    }
+
+    void await_resume() const noexcept {}
+};
+
+//! Suspends the coroutine running as a task of the group until resume is called for the suspend point
+/** The group does not complete while the coroutine is suspended. The coroutine is resumed by a
+    task of the group in the arena where it has been suspended. If the group is cancelled
+    meanwhile, the coroutine is destroyed instead of resumed. **/
+template <typename F>
+coroutine_suspender<typename std::decay<F>::type> suspend_coroutine(task_group_base& tg, F&& callback) {
+    return { tg, std::forward<F>(callback) };
+}
+
+//! Suspends the coroutine until resume is called for the suspend point
+/** The coroutine is resumed by a task enqueued into the arena. **/
+template <typename F>
+coroutine_suspender<typename std::decay<F>::type> suspend_coroutine(task_arena& ta, F&& callback) {
+    return { ta, std::forward<F>(callback) };
+}
+
+//! Resumes the suspended coroutine; can be called by any thread
+inline void resume(coroutine_suspend_point sp) {
+    __TBB_ASSERT(sp && sp->m_handle, "Invalid coroutine suspend point");
+    small_object_allocator alloc{};
+    task& t = *alloc.new_object<coroutine_resume_task>(*sp, alloc);
+    // Do not access the suspend point after the task is submitted because the frame can be destroyed
+    task_arena& ta = *sp->m_arena;
+    if (task_group_context* ctx = sp->m_context) {
+        submit(t, ta, *ctx, /*as_critical = */ false);
+    } else {
+        r1::enqueue(t, &ta);
+    }
+}
+
+} // namespace d1
+} // namespace detail
+
+inline namespace v1 {
+namespace task {
+    using detail::d1::coroutine_task;
+    using detail::d1::coroutine_suspend_point;
+    using detail::d1::suspend_coroutine;
+    using detail::d1::resume;
+} // namespace task
+} // namespace v1
+
+} // namespace tbb
+
+#endif /* __TBB_CPP20_COROUTINES_PRESENT */
+
+#endif /* __TBB_task_coroutine_H */
@@ -0,0 +1,304 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_task_dag_H
+#define __TBB_task_dag_H
+
+#include "detail/_config.h"
+#include "detail/_namespace_injection.h"
+#include "detail/_exception.h"
+#include "detail/_task.h"
+#include "detail/_template_helpers.h"
+#include "detail/_small_object_pool.h"
+
+#include "task_group.h"
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace tbb {
+namespace detail {
+namespace d1 {
+
+class task_dag_node_base;
+
+//! Entry of the successor list of a task_dag node
+struct task_dag_edge {
+    task_dag_node_base* successor;
+    task_dag_edge* next;
+    small_object_allocator allocator;
+};
+
+//! Base class of the task_dag nodes
+/** A node is a task that is spawned when its predecessor counter drops to zero. The counter
+    includes one extra reference that is held until the node is started by task_dag::run, so
+    the successors can be declared before any of the predecessors is run. The successor list
+    is closed when the node completes, and the edges added after that are ignored. The node
+    itself stays allocated until task_dag::wait returns, so it can be referred to meanwhile. **/
+class task_dag_node_base : public task {
+    static task_dag_edge* completed_mark() {
+        return reinterpret_cast<task_dag_edge*>(std::uintptr_t(1));
+    }
+
+protected:
+    wait_context& m_wait_ctx;
+    task_group_context& m_context;
+    std::atomic<std::uint64_t> m_num_predecessors{1};
+    std::atomic<task_dag_edge*> m_successors{nullptr};
+    //! The next node in the list of all the nodes of the DAG
+    task_dag_node_base* m_next_node{nullptr};
+    //! The next node in the list of the nodes that are not started yet
+    task_dag_node_base* m_next_unstarted{nullptr};
+    small_object_allocator m_allocator;
+
+    task_dag_node_base(wait_context& wo, task_group_context& ctx, small_object_allocator& alloc)
+        : m_wait_ctx(wo), m_context(ctx), m_allocator(alloc) {}
+
+    //! Returns true if the last predecessor of the node has been released
+    bool release_predecessor() {
+        return m_num_predecessors.fetch_sub(1) == 1;
+    }
+
+    //! Closes the successor list and releases the successors
+    /** Returns one of the successors that became ready to execute it without spawning. **/
+    task* complete(const execution_data& ed) {
+        task_dag_edge* e = m_successors.exchange(completed_mark());
+        __TBB_ASSERT(e != completed_mark(), "The node has been completed twice");
+        task* bypass_task = nullptr;
+        while (e != nullptr) {
+            task_dag_edge* next = e->next;
+            task_dag_node_base* successor = e->successor;
+            auto allocator = e->allocator;
+            allocator.delete_object(e, ed);
+            if (successor->release_predecessor()) {
+                if (bypass_task == nullptr) {
+                    bypass_task = successor;
+                } else {
+                    spawn(*successor, m_context);
+                }
+            }
+            e = next;
+        }
+        // The successors hold their own references to the wait context
+        m_wait_ctx.release();
+        return bypass_task;
+    }
+
+    task* cancel(execution_data& ed) override {
+        // The successors are cancelled as well when the scheduler takes them
+        return complete(ed);
+    }
+
+    //! Destroys the completed node
+    virtual void destroy() = 0;
+
+    friend class task_dag;
+};
+
+template <typename F>
+class task_dag_node : public task_dag_node_base {
+    const F m_func;
+
+    task* execute(execution_data& ed) override {
+        // If the body throws, the scheduler cancels the DAG and then calls cancel for this node
+        m_func();
+        return complete(ed);
+    }
+
+    void destroy() override {
+        auto allocator = m_allocator;
+        this->~task_dag_node();
+        allocator.deallocate(this);
+    }
+
+public:
+    template <typename Body>
+    task_dag_node(Body&& f, wait_context& wo, task_group_context& ctx, small_object_allocator& alloc)
+        : task_dag_node_base(wo, ctx, alloc), m_func(std::forward<Body>(f)) {}
+};
+
+//! Dynamic graph of tasks with dependencies
+/** @ingroup task_scheduling
+    A lightweight alternative to flow::graph with continue_node for directed acyclic graphs of
+    small tasks. Each node keeps an atomic counter of incomplete predecessors and a lock-free list
+    of successors; completing a node decrements the counters of its successors and runs the ready
+    ones. Nodes and edges can be added concurrently, including from the bodies of running nodes. **/
+class task_dag : no_copy {
+public:
+    //! Refers to a node of the DAG until task_dag::wait returns
+    class node {
+        task_dag_node_base* m_node{nullptr};
+
+        explicit node(task_dag_node_base* n) : m_node(n) {}
+        friend class task_dag;
+    public:
+        node() = default;
+
+        explicit operator bool() const noexcept { return m_node != nullptr; }
+    };
+
+    task_dag()
+        : m_wait_ctx(0)
+        , m_context(task_group_context::bound, task_group_context::default_traits | task_group_context::concurrent_wait)
+    {}
+
+    ~task_dag() noexcept(false) {
+        if (m_nodes.load(std::memory_order_relaxed) != nullptr) {
+#if __TBB_CPP17_UNCAUGHT_EXCEPTIONS_PRESENT
+            bool stack_unwinding_in_progress = std::uncaught_exceptions() > 0;
+#else
+            bool stack_unwinding_in_progress = std::uncaught_exception();
+#endif
+            // Always attempt to do proper cleanup to avoid inevitable memory corruption
+            // in case of missing wait (for the sake of better testability & debuggability)
+            if (!m_context.is_group_execution_cancelled())
+                cancel();
+            run();
+            d1::wait(m_wait_ctx, m_context);
+            destroy_nodes();
+            if (!stack_unwinding_in_progress)
+                throw_exception(exception_id::missing_wait);
+        }
+    }
+
+    //! Adds a node that executes the function object
+    /** The node is not started until the next call to run or wait. **/
+    template <typename F>
+    node add(F&& f) {
+        m_wait_ctx.reserve();
+        small_object_allocator alloc{};
+        task_dag_node_base* n = alloc.new_object<task_dag_node<typename std::decay<F>::type>>(
+            std::forward<F>(f), m_wait_ctx, m_context, alloc);
+        push(m_nodes, n, &task_dag_node_base::m_next_node);
+        push(m_unstarted, n, &task_dag_node_base::m_next_unstarted);
+        return node{ n };
+    }
+
+    //! Makes the successor wait for the completion of the predecessor
+    /** The successor must not be ready to run: it must be either not started yet or waiting
+        for another predecessor, e.g. for the node calling this method. If the predecessor has
+        already completed, the edge has no effect. **/
+    void make_edge(node predecessor, node successor) {
+        __TBB_ASSERT(predecessor && successor, "Invalid node");
+        __TBB_ASSERT(predecessor.m_node != successor.m_node, "A node cannot depend on itself");
+        task_dag_node_base& pred = *predecessor.m_node;
+        task_dag_node_base& succ = *successor.m_node;
+        succ.m_num_predecessors.fetch_add(1, std::memory_order_relaxed);
+
+        small_object_allocator alloc{};
+        task_dag_edge* e = alloc.new_object<task_dag_edge>(task_dag_edge{ &succ, nullptr, alloc });
+        // The allocator is bound to the memory pool by the allocation
+        e->allocator = alloc;
+        task_dag_edge* head = pred.m_successors.load(std::memory_order_acquire);
+        do {
+            if (head == task_dag_node_base::completed_mark()) {
+                // The successor still holds its start reference, so it cannot become ready here
+                bool is_ready = succ.release_predecessor();
+                __TBB_ASSERT_EX(!is_ready, "The successor is not waiting for any predecessor");
+                alloc.delete_object(e);
+                return;
+            }
+            e->next = head;
+        } while (!pred.m_successors.compare_exchange_weak(head, e));
+    }
+
+    //! Starts the nodes that are not started yet
+    /** The nodes without incomplete predecessors are spawned right away. Can be called
+        concurrently, e.g. by the running nodes that have added new ones. **/
+    void run() {
+        task_dag_node_base* head = m_unstarted.exchange(nullptr);
+
+        constexpr std::size_t max_batch_size = 64;
+        task* ready[max_batch_size];
+        std::size_t batch_size = 0;
+        for (task_dag_node_base* n = head; n != nullptr;) {
+            // Read the link first because the started node can complete at any moment
+            task_dag_node_base* next = n->m_next_unstarted;
+            if (n->release_predecessor()) {
+                ready[batch_size++] = n;
+                if (batch_size == max_batch_size) {
+                    spawn(ready, batch_size, m_context);
+                    batch_size = 0;
+                }
+            }
+            n = next;
+        }
+        if (batch_size > 0) {
+            spawn(ready, batch_size, m_context);
+        }
+    }
+
+    //! Starts the remaining nodes and waits for all the nodes to complete
+    /** The nodes added by the running nodes must be started by them with run(). All the nodes
+        are destroyed afterwards, so the DAG can be reused. **/
+    task_group_status wait() {
+        run();
+        bool cancellation_status = false;
+        try_call([&] {
+            d1::wait(m_wait_ctx, m_context);
+        }).on_completion([&] {
+            // TODO: the reset method is not thread-safe. Ensure the correct behavior.
+            cancellation_status = m_context.is_group_execution_cancelled();
+            m_context.reset();
+            destroy_nodes();
+        });
+        return cancellation_status ? canceled : complete;
+    }
+
+    //! Cancels the nodes that have not started execution yet
+    void cancel() {
+        m_context.cancel_group_execution();
+    }
+
+private:
+    static void push(std::atomic<task_dag_node_base*>& list, task_dag_node_base* n,
+                     task_dag_node_base* task_dag_node_base::* link) {
+        task_dag_node_base* head = list.load(std::memory_order_relaxed);
+        do {
+            n->*link = head;
+        } while (!list.compare_exchange_weak(head, n));
+    }
+
+    void destroy_nodes() {
+        __TBB_ASSERT(m_unstarted.load(std::memory_order_relaxed) == nullptr, "Not all the nodes were started");
+        task_dag_node_base* n = m_nodes.exchange(nullptr, std::memory_order_relaxed);
+        while (n != nullptr) {
+            task_dag_node_base* next = n->m_next_node;
+            n->destroy();
+            n = next;
+        }
+    }
+
+    wait_context m_wait_ctx;
+    task_group_context m_context;
+    //! All the nodes of the DAG, the most recently added first
+    std::atomic<task_dag_node_base*> m_nodes{nullptr};
+    //! The nodes that are not started yet, the most recently added first
+    std::atomic<task_dag_node_base*> m_unstarted{nullptr};
+};
+
+} // namespace d1
+} // namespace detail
+
+inline namespace v1 {
+using detail::d1::task_dag;
+} // namespace v1
+
+} // namespace tbb
+
+#endif /* __TBB_task_dag_H */
@@ -42,6 +42,7 @@ namespace d1 {
 class delegate_base;
 class task_arena_base;
 class task_group_context;
+struct coroutine_suspend_point_type;
 }
 
 namespace r1 {
@@ -163,6 +164,10 @@ private:
     //! Used to set and maintain stack stitching point for Intel Performance Tools.
     void* my_itt_caller;
 
+    //! The cancellation epoch (plus one) at which no ancestor of this context was cancelled.
+    /** Allows to skip the check of the ancestors until another context is cancelled. */
+    std::atomic<std::uintptr_t> my_cancellation_epoch;
+
     //! Description of algorithm for scheduler based instrumentation.
     string_resource_index my_name;
 
@@ -178,6 +183,7 @@ private:
         - sizeof(context_list_node) // my_node
         - sizeof(r1::tbb_exception_ptr*) // my_exception
         - sizeof(void*) // my_itt_caller
+        - sizeof(std::atomic<std::uintptr_t>) // my_cancellation_epoch
         - sizeof(string_resource_index) // my_name
     ];
 
@@ -242,7 +248,13 @@ public:
 
         IMPORTANT: This method is not thread safe!
 
-        The method does not change the context's parent if it is set. **/
+        The method does not change the context's parent if it is set.
+
+        The cancellation of an ancestor is not copied to the bound contexts when it happens:
+        a context finds it on the next is_group_execution_cancelled() check. Thus resetting
+        a context while one of its ancestors stays cancelled does not resume its work: the
+        next check observes the ancestor and marks the context cancelled again, whether or not
+        the cancellation had already reached the context before the reset. **/
     void reset() {
         r1::reset(*this);
     }
@@ -310,41 +322,189 @@ class structured_task_group;
 class isolated_task_group;
 #endif
 
+//! Base class of the tasks created by a task_group
+/** Besides the wait context of the group, the task can refer to a continuation that is released
+    when the task completes, and (if the task is a continuation itself) counts its incomplete
+    predecessors. **/
+class task_group_task : public task {
+protected:
+    wait_context& m_wait_ctx;
+    task_group_task* m_successor;
+    std::atomic<std::uint32_t> m_num_predecessors{0};
+
+    task_group_task(wait_context& wo, task_group_task* successor)
+        : m_wait_ctx(wo)
+        , m_successor(successor) {}
+
+    //! Releases the successor of the task and returns it if it has no more incomplete predecessors
+    static task* release_successor(task_group_task* successor) {
+        if (successor && successor->m_num_predecessors.fetch_sub(1) == 1) {
+            return successor;
+        }
+        return nullptr;
+    }
+
+public:
+    //! Destroys the task that has never been run and releases the wait context of the group
+    virtual void destroy() = 0;
+
+    friend class task_handle;
+    friend class task_group;
+};
+
+//! Owns a task of a task_group that is not run yet
+/** The task is run by task_group::run or by the scheduler right after a task of the same group
+    that returned the handle from its body, bypassing the task pool. A handle destroyed without
+    running the task releases the group and the continuation of the task; if that was the last
+    predecessor of the continuation, the continuation is destroyed without running as well. **/
+class task_handle {
+    task_group_task* m_task{nullptr};
+
+    explicit task_handle(task_group_task* t) : m_task(t) {}
+
+    task_group_task* release() {
+        task_group_task* t = m_task;
+        m_task = nullptr;
+        return t;
+    }
+
+    bool belongs_to(const wait_context& wo) const {
+        return &m_task->m_wait_ctx == &wo;
+    }
+
+    friend class task_group;
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+    friend class isolated_task_group;
+#endif
+    template <typename F> friend task* invoke_body(const F&, const wait_context&, std::true_type);
+public:
+    task_handle() = default;
+    task_handle(const task_handle&) = delete;
+    task_handle& operator=(const task_handle&) = delete;
+
+    task_handle(task_handle&& h) noexcept : m_task(h.release()) {}
+
+    task_handle& operator=(task_handle&& h) noexcept {
+        if (this != &h) {
+            task_handle(std::move(h)).swap(*this);
+        }
+        return *this;
+    }
+
+    ~task_handle() {
+        if (m_task) {
+            m_task->destroy();
+        }
+    }
+
+    void swap(task_handle& h) noexcept {
+        task_group_task* t = m_task;
+        m_task = h.m_task;
+        h.m_task = t;
+    }
+
+    explicit operator bool() const noexcept { return m_task != nullptr; }
+};
+
+//! Refers to a task of a task_group that is run after a number of its predecessors complete
+/** The task is created by task_group::make_continuation and becomes a successor of the tasks
+    passed to task_group::run or task_group::defer together with the continuation. Exactly the
+    specified number of such tasks must be run or dropped, otherwise the group never completes. **/
+class continuation {
+    task_group_task* m_task{nullptr};
+
+    explicit continuation(task_group_task* t) : m_task(t) {}
+
+    friend class task_group;
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+    friend class isolated_task_group;
+#endif
+public:
+    continuation() = default;
+
+    explicit operator bool() const noexcept { return m_task != nullptr; }
+};
+
+//! Calls the body of a task and returns the task to bypass if the body returned a task_handle
+template <typename F>
+task* invoke_body(const F& f, const wait_context& wo, std::true_type) {
+    task_handle h = f();
+    __TBB_ASSERT(!h || h.belongs_to(wo), "The returned task must belong to the same task_group");
+    suppress_unused_warning(wo);
+    return h.release();
+}
+
+template <typename F>
+task* invoke_body(const F& f, const wait_context&, std::false_type) {
+    f();
+    return nullptr;
+}
+
+template <typename F>
+task* invoke_body(const F& f, const wait_context& wo) {
+    using returns_task_handle = std::is_same<typename std::decay<decltype(f())>::type, task_handle>;
+    return invoke_body(f, wo, returns_task_handle{});
+}
+
 template<typename F>
-class function_task : public task {
+class function_task : public task_group_task {
     const F m_func;
-    wait_context& m_wait_ctx;
     small_object_allocator m_allocator;
 
-    void finalize(const execution_data& ed) {
+    //! Destroys the task and returns its successor if the latter is ready to run
+    task* finalize(const execution_data& ed) {
         // Make a local reference not to access this after destruction.
         wait_context& wo = m_wait_ctx;
+        task_group_task* successor = m_successor;
         // Copy allocator to the stack
         auto allocator = m_allocator;
         // Destroy user functor before release wait.
         this->~function_task();
+        // The successor holds its own reference to the wait context, so it is safe
+        // to release the group afterwards.
+        task* next = release_successor(successor);
         wo.release();
 
         allocator.deallocate(this, ed);
+        return next;
     }
     task* execute(execution_data& ed) override {
-        m_func();
-        finalize(ed);
-        return nullptr;
+        task* next = invoke_body(m_func, m_wait_ctx);
+        task* successor = finalize(ed);
+        if (next == nullptr) {
+            return successor;
+        }
+        if (successor != nullptr) {
+            spawn(*successor, *context(ed));
+        }
+        return next;
     }
     task* cancel(execution_data& ed) override {
-        finalize(ed);
-        return nullptr;
+        // The successor is cancelled as well when the scheduler takes it.
+        return finalize(ed);
+    }
+    void destroy() override {
+        wait_context& wo = m_wait_ctx;
+        task_group_task* successor = m_successor;
+        auto allocator = m_allocator;
+        this->~function_task();
+        // The task counts as a completed predecessor. A continuation left without
+        // predecessors cannot run either, so it is destroyed the same way.
+        if (task* next = release_successor(successor)) {
+            static_cast<task_group_task*>(next)->destroy();
+        }
+        wo.release();
+        allocator.deallocate(this);
     }
 public:
-    function_task(const F& f, wait_context& wo, small_object_allocator& alloc)
-        : m_func(f)
-        , m_wait_ctx(wo)
+    function_task(const F& f, wait_context& wo, small_object_allocator& alloc, task_group_task* successor = nullptr)
+        : task_group_task(wo, successor)
+        , m_func(f)
         , m_allocator(alloc) {}
 
-    function_task(F&& f, wait_context& wo, small_object_allocator& alloc)
-        : m_func{ std::move(f) }
-        , m_wait_ctx(wo)
+    function_task(F&& f, wait_context& wo, small_object_allocator& alloc, task_group_task* successor = nullptr)
+        : task_group_task(wo, successor)
+        , m_func{ std::move(f) }
         , m_allocator(alloc) {}
 };
 
@@ -357,9 +517,9 @@ class function_stack_task : public task {
         m_wait_ctx.release();
     }
     task* execute(execution_data&) override {
-        m_func();
+        task* next = invoke_body(m_func, m_wait_ctx);
         finalize();
-        return nullptr;
+        return next;
     }
     task* cancel(execution_data&) override {
         finalize();
@@ -370,6 +530,7 @@ public:
 };
 
 class task_group_base : no_copy {
+    friend struct coroutine_suspend_point_type;
 protected:
     wait_context m_wait_ctx;
     task_group_context m_context;
@@ -390,10 +551,10 @@ protected:
     }
 
     template<typename F>
-    task* prepare_task(F&& f) {
+    task_group_task* prepare_task(F&& f, task_group_task* successor = nullptr) {
         m_wait_ctx.reserve();
         small_object_allocator alloc{};
-        return alloc.new_object<function_task<typename std::decay<F>::type>>(std::forward<F>(f), m_wait_ctx, alloc);
+        return alloc.new_object<function_task<typename std::decay<F>::type>>(std::forward<F>(f), m_wait_ctx, alloc, successor);
     }
 
 public:
@@ -446,6 +607,87 @@ public:
         spawn(*prepare_task(std::forward<F>(f)), m_context);
     }
 
+    //! Runs the function object as a task with the given priority within the arena
+    template<typename F>
+    void run(F&& f, task_priority priority) {
+        spawn(*prepare_task(std::forward<F>(f)), m_context, priority);
+    }
+
+    //! Runs the function object as one of the predecessors of the continuation
+    template<typename F>
+    void run(F&& f, continuation successor) {
+        __TBB_ASSERT(successor, "The continuation must be created by make_continuation");
+        spawn(*prepare_task(std::forward<F>(f), successor.m_task), m_context);
+    }
+
+    //! Runs the task owned by the handle
+    void run(task_handle&& h) {
+        __TBB_ASSERT(h, "Cannot run an empty task_handle");
+        spawn(*h.release(), m_context);
+    }
+
+    //! Creates a task that is run later via run(task_handle&&) or by returning the handle from a task body
+    /** Returning the handle from the body of another task of the group makes the calling thread
+        execute the task right after that body, avoiding a round trip through the task pool. **/
+    template<typename F>
+    task_handle defer(F&& f) {
+        return task_handle{ prepare_task(std::forward<F>(f)) };
+    }
+
+    //! Creates a task that is a predecessor of the continuation and is run later
+    template<typename F>
+    task_handle defer(F&& f, continuation successor) {
+        __TBB_ASSERT(successor, "The continuation must be created by make_continuation");
+        return task_handle{ prepare_task(std::forward<F>(f), successor.m_task) };
+    }
+
+    //! Creates a task that is run when num_predecessors tasks of the group referring to it complete
+    /** The task is executed by the thread that completes the last predecessor, right after it.
+        If the successor is specified, the new continuation becomes one more predecessor of it, so
+        a task can pass its own successor on to the continuation of the work it splits off. The
+        successor must have incomplete predecessors at the moment of the call. **/
+    template<typename F>
+    continuation make_continuation(F&& f, std::uint32_t num_predecessors, continuation successor = continuation{}) {
+        __TBB_ASSERT(num_predecessors > 0, "A continuation must have at least one predecessor");
+        if (successor) {
+            __TBB_ASSERT(successor.m_task->m_num_predecessors.load(std::memory_order_relaxed) > 0,
+                "The successor has been already released");
+            successor.m_task->m_num_predecessors.fetch_add(1, std::memory_order_relaxed);
+        }
+        task_group_task* t = prepare_task(std::forward<F>(f), successor.m_task);
+        t->m_num_predecessors.store(num_predecessors, std::memory_order_relaxed);
+        return continuation{ t };
+    }
+
+    //! Runs a copy of each function object from [first, last) as a separate task.
+    /** The tasks are spawned in batches that are published with a single store and announced
+        to the other threads once per batch. **/
+    template<typename Iterator>
+    void run_batch(Iterator first, Iterator last) {
+        constexpr std::size_t max_batch_size = 64;
+        task* tasks[max_batch_size];
+        std::size_t batch_size = 0;
+        auto spawn_batch = [&] {
+            std::size_t num_tasks = batch_size;
+            batch_size = 0;
+            spawn(tasks, num_tasks, m_context);
+        };
+        try_call([&] {
+            for (; first != last; ++first) {
+                tasks[batch_size++] = prepare_task(*first);
+                if (batch_size == max_batch_size) {
+                    spawn_batch();
+                }
+            }
+        }).on_completion([&] {
+            // The prepared tasks are run even if the preparation of the next ones has failed,
+            // otherwise the group would wait for them forever.
+            if (batch_size > 0) {
+                spawn_batch();
+            }
+        });
+    }
+
     template<typename F>
     task_group_status run_and_wait(const F& f) {
         return internal_run_and_wait(f);
@@ -456,13 +698,18 @@ public:
 class spawn_delegate : public delegate_base {
     task* task_to_spawn;
     task_group_context& context;
+    task_priority priority;
     bool operator()() const override {
-        spawn(*task_to_spawn, context);
+        if (priority == task_priority::normal) {
+            spawn(*task_to_spawn, context);
+        } else {
+            spawn(*task_to_spawn, context, priority);
+        }
         return true;
     }
 public:
-    spawn_delegate(task* a_task, task_group_context& ctx)
-        : task_to_spawn(a_task), context(ctx)
+    spawn_delegate(task* a_task, task_group_context& ctx, task_priority a_priority = task_priority::normal)
+        : task_to_spawn(a_task), context(ctx), priority(a_priority)
     {}
 };
 
@@ -491,6 +738,20 @@ public:
         : wait_delegate(a_group, tgs), func(a_func) {}
 };
 
+template<typename Iterator>
+class run_batch_delegate : public delegate_base {
+    task_group& tg;
+    Iterator& first;
+    Iterator& last;
+    bool operator()() const override {
+        tg.run_batch(first, last);
+        return true;
+    }
+public:
+    run_batch_delegate(task_group& a_group, Iterator& a_first, Iterator& a_last)
+        : tg(a_group), first(a_first), last(a_last) {}
+};
+
 class isolated_task_group : public task_group {
     intptr_t this_isolation() {
         return reinterpret_cast<intptr_t>(this);
@@ -504,6 +765,31 @@ public:
         r1::isolate_within_arena(sd, this_isolation());
     }
 
+    template<typename F>
+    void run(F&& f, task_priority priority) {
+        spawn_delegate sd(prepare_task(std::forward<F>(f)), m_context, priority);
+        r1::isolate_within_arena(sd, this_isolation());
+    }
+
+    template<typename F>
+    void run(F&& f, continuation successor) {
+        __TBB_ASSERT(successor, "The continuation must be created by make_continuation");
+        spawn_delegate sd(prepare_task(std::forward<F>(f), successor.m_task), m_context);
+        r1::isolate_within_arena(sd, this_isolation());
+    }
+
+    void run(task_handle&& h) {
+        __TBB_ASSERT(h, "Cannot run an empty task_handle");
+        spawn_delegate sd(h.release(), m_context);
+        r1::isolate_within_arena(sd, this_isolation());
+    }
+
+    template<typename Iterator>
+    void run_batch(Iterator first, Iterator last) {
+        run_batch_delegate<Iterator> rbd(*this, first, last);
+        r1::isolate_within_arena(rbd, this_isolation());
+    }
+
     template<typename F>
     task_group_status run_and_wait( const F& f ) {
         task_group_status result = not_complete;
@@ -534,11 +820,14 @@ inline bool is_current_task_group_canceling() {
 inline namespace v1 {
 using detail::d1::task_group_context;
 using detail::d1::task_group;
+using detail::d1::task_handle;
+using detail::d1::continuation;
 #if TBB_PREVIEW_ISOLATED_TASK_GROUP
 using detail::d1::isolated_task_group;
 #endif
 
 using detail::d1::task_group_status;
+using detail::d1::task_priority;
 using detail::d1::not_complete;
 using detail::d1::complete;
 using detail::d1::canceled;
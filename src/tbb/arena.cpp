@@ -34,16 +34,23 @@ namespace r1 {
 #if __TBB_NUMA_SUPPORT
 class numa_binding_observer : public tbb::task_scheduler_observer {
     int my_numa_node_id;
+    //! One of d1::task_arena_base::thread_pinning values
+    int my_pinning_policy;
     binding_handler* my_binding_handler;
 public:
-    numa_binding_observer( d1::task_arena* ta, int numa_id, int num_slots )
+    numa_binding_observer( d1::task_arena* ta, int numa_id, int pinning_policy, int num_slots )
         : task_scheduler_observer(*ta)
         , my_numa_node_id(numa_id)
+        , my_pinning_policy(pinning_policy)
         , my_binding_handler(construct_binding_handler(num_slots))
     {}
 
     void on_scheduler_entry( bool ) override {
-        bind_thread_to_node( my_binding_handler, this_task_arena::current_thread_index(), my_numa_node_id);
+        if (my_pinning_policy != int(d1::task_arena_base::thread_pinning::none)) {
+            bind_thread_to_core(my_binding_handler, this_task_arena::current_thread_index(), my_numa_node_id, my_pinning_policy);
+        } else {
+            bind_thread_to_node( my_binding_handler, this_task_arena::current_thread_index(), my_numa_node_id);
+        }
     }
 
     void on_scheduler_exit( bool ) override {
@@ -55,11 +62,15 @@ public:
     }
 };
 
-numa_binding_observer* construct_binding_observer( d1::task_arena* ta, int numa_id, int num_slots ) {
+numa_binding_observer* construct_binding_observer( d1::task_arena* ta, int numa_id, int pinning_policy, int num_slots ) {
     numa_binding_observer* binding_observer = nullptr;
     // numa_topology initialization will be lazily performed inside nodes_count() call
-    if (numa_id >= 0 && numa_node_count() > 1) {
-        binding_observer = new(allocate_memory(sizeof(numa_binding_observer))) numa_binding_observer(ta, numa_id, num_slots);
+    bool bind_to_node = numa_id >= 0 && numa_node_count() > 1;
+    bool pin_to_cores = pinning_policy != int(d1::task_arena_base::thread_pinning::none);
+    if (bind_to_node || pin_to_cores) {
+        numa_topology::initialize();
+        binding_observer = new(allocate_memory(sizeof(numa_binding_observer)))
+            numa_binding_observer(ta, bind_to_node ? numa_id : -1, pinning_policy, num_slots);
         __TBB_ASSERT(binding_observer, "Failure during NUMA binding observer allocation and construction");
         binding_observer->observe(true);
     }
@@ -121,6 +132,7 @@ void arena::process(thread_data& tls) {
     }
     __TBB_ASSERT( index >= my_num_reserved_slots, "Workers cannot occupy reserved slots" );
     tls.attach_arena(*this, index);
+    RECORD_TRACE_EVENT(tls, arena_join, index);
 
     task_dispatcher& task_disp = tls.my_arena_slot->default_task_dispatcher();
     task_disp.set_stealing_threshold(calculate_stealing_threshold());
@@ -128,7 +140,8 @@ void arena::process(thread_data& tls) {
     tls.attach_task_dispatcher(task_disp);
 
     __TBB_ASSERT( !tls.my_last_observer, "There cannot be notified local observers when entering arena" );
-    my_observers.notify_entry_observers(tls.my_last_observer, tls.my_is_worker);
+    tls.my_last_observer_epoch = 0;
+    my_observers.notify_entry_observers(tls.my_last_observer, tls.my_last_observer_epoch, tls.my_is_worker);
 
     // Waiting on special object tied to this arena
     outermost_worker_waiter waiter(*this);
@@ -139,12 +152,14 @@ void arena::process(thread_data& tls) {
 
     my_observers.notify_exit_observers(tls.my_last_observer, tls.my_is_worker);
     tls.my_last_observer = nullptr;
+    tls.my_last_observer_epoch = 0;
 
     task_disp.set_stealing_threshold(0);
     tls.detach_task_dispatcher();
 
     // Arena slot detach (arena may be used in market::process)
     // TODO: Consider moving several calls below into a new method(e.g.detach_arena).
+    RECORD_TRACE_EVENT(tls, arena_leave, tls.my_arena_index);
     tls.my_arena_slot->release();
     tls.my_arena_slot = nullptr;
     tls.my_inbox.detach();
@@ -188,16 +203,28 @@ arena::arena ( market& m, unsigned num_slots, unsigned num_reserved_slots, unsig
         my_slots[i].init_task_streams(i);
         my_slots[i].my_default_task_dispatcher = new(base_td_pointer + i) task_dispatcher(this);
         my_slots[i].my_is_occupied.store(false, std::memory_order_relaxed);
+#if __TBB_NUMA_SUPPORT
+        my_slots[i].my_numa_node.store(-1, std::memory_order_relaxed);
+#endif
     }
     my_fifo_task_stream.initialize(my_num_slots);
     my_resume_task_stream.initialize(my_num_slots);
 #if __TBB_PREVIEW_CRITICAL_TASKS
     my_critical_task_stream.initialize(my_num_slots);
 #endif
+    my_low_priority_task_stream.initialize(my_num_slots);
 #if __TBB_ENQUEUE_ENFORCED_CONCURRENCY
     my_local_concurrency_mode = false;
     my_global_concurrency_mode.store(false, std::memory_order_relaxed);
 #endif
+#if __TBB_NUMA_SUPPORT
+    my_numa_aware_stealing = false;
+#endif
+    my_num_deferred_external_slots.store(0, std::memory_order_relaxed);
+    my_num_delegated_executions.store(0, std::memory_order_relaxed);
+    my_num_missed_deadlines.store(0, std::memory_order_relaxed);
+    // Start with the estimate reproducing the default spinning duration
+    my_idle_gap_estimate.store(stealing_loop_backoff::default_yield_threshold / 2, std::memory_order_relaxed);
 }
 
 arena& arena::allocate_arena( market& m, unsigned num_slots, unsigned num_reserved_slots,
@@ -236,6 +263,8 @@ void arena::free_arena () {
     }
     __TBB_ASSERT(my_fifo_task_stream.empty(), "Not all enqueued tasks were executed");
     __TBB_ASSERT(my_resume_task_stream.empty(), "Not all enqueued tasks were executed");
+    __TBB_ASSERT(my_low_priority_task_stream.empty(), "Not all low priority tasks were executed");
+    __TBB_ASSERT(my_deadline_task_stream.empty(), "Not all enqueued tasks were executed");
     // Cleanup coroutines/schedulers cache
     my_co_cache.cleanup();
     my_default_ctx->~task_group_context();
@@ -259,7 +288,7 @@ void arena::free_arena () {
 }
 
 bool arena::has_enqueued_tasks() {
-    return !my_fifo_task_stream.empty();
+    return !my_fifo_task_stream.empty() || !my_deadline_task_stream.empty();
 }
 
 bool arena::is_out_of_work() {
@@ -299,7 +328,8 @@ bool arena::is_out_of_work() {
                     bool work_absent = k == n;
                     // Test and test-and-set.
                     if( my_pool_state.load(std::memory_order_acquire)==busy ) {
-                        bool no_stream_tasks = my_fifo_task_stream.empty() && my_resume_task_stream.empty();
+                        bool no_stream_tasks = my_fifo_task_stream.empty() && my_resume_task_stream.empty()
+                            && my_low_priority_task_stream.empty() && my_deadline_task_stream.empty();
 #if __TBB_PREVIEW_CRITICAL_TASKS
                         no_stream_tasks = no_stream_tasks && my_critical_task_stream.empty();
 #endif
@@ -339,6 +369,14 @@ void arena::enqueue_task(d1::task& t, d1::task_group_context& ctx, thread_data&
     advertise_new_work<work_enqueued>();
 }
 
+void arena::enqueue_task(d1::task& t, d1::task_group_context& ctx, thread_data& td, std::int64_t deadline) {
+    task_group_context_impl::bind_to(ctx, &td);
+    task_accessor::context(t) = &ctx;
+    task_accessor::isolation(t) = no_isolation;
+    my_deadline_task_stream.push( &t, deadline );
+    advertise_new_work<work_enqueued>();
+}
+
 } // namespace r1
 } // namespace detail
 } // namespace tbb
@@ -381,9 +419,12 @@ struct task_arena_impl {
     static void terminate(d1::task_arena_base&);
     static bool attach(d1::task_arena_base&);
     static void execute(d1::task_arena_base&, d1::delegate_base&);
+    static void execute_delegated(thread_data&, arena&, d1::delegate_base&);
     static void wait(d1::task_arena_base&);
     static int max_concurrency(const d1::task_arena_base*);
     static void enqueue(d1::task&, d1::task_arena_base*);
+    static void enqueue(d1::task&, d1::task_arena_base*, std::int64_t);
+    static bool query_statistics(const d1::task_arena_base&, d1::arena_statistics&);
 };
 
 void __TBB_EXPORTED_FUNC initialize(d1::task_arena_base& ta) {
@@ -410,6 +451,14 @@ void __TBB_EXPORTED_FUNC enqueue(d1::task& t, d1::task_arena_base* ta) {
     task_arena_impl::enqueue(t, ta);
 }
 
+void __TBB_EXPORTED_FUNC enqueue(d1::task& t, d1::task_arena_base* ta, std::int64_t deadline) {
+    task_arena_impl::enqueue(t, ta, deadline);
+}
+
+bool __TBB_EXPORTED_FUNC query_statistics(const d1::task_arena_base& ta, d1::arena_statistics& stats) {
+    return task_arena_impl::query_statistics(ta, stats);
+}
+
 void task_arena_impl::initialize(d1::task_arena_base& ta) {
     governor::one_time_init();
     if (ta.my_max_concurrency < 1) {
@@ -428,8 +477,20 @@ void task_arena_impl::initialize(d1::task_arena_base& ta) {
     // add an internal market reference; a public reference was added in create_arena
     market::global_market( /*is_public=*/false);
 #if __TBB_NUMA_SUPPORT
+    using thread_pinning = d1::task_arena_base::thread_pinning;
+    thread_pinning pinning = thread_pinning::none;
+    if (ta.my_version_and_traits & d1::task_arena_base::compact_pinning_flag) {
+        pinning = thread_pinning::compact;
+    } else if (ta.my_version_and_traits & d1::task_arena_base::scatter_pinning_flag) {
+        pinning = thread_pinning::scatter;
+    }
     ta.my_arena->my_numa_binding_observer = construct_binding_observer(
-        static_cast<d1::task_arena*>(&ta), ta.my_numa_id, ta.my_arena->my_num_slots);
+        static_cast<d1::task_arena*>(&ta), ta.my_numa_id, int(pinning), ta.my_arena->my_num_slots);
+    if (ta.my_version_and_traits & d1::task_arena_base::numa_aware_stealing_flag) {
+        // Threads look up their NUMA node via TBBbind when entering the arena.
+        numa_topology::initialize();
+        ta.my_arena->my_numa_aware_stealing = true;
+    }
 #endif /*__TBB_NUMA_SUPPORT*/
 }
 
@@ -475,6 +536,14 @@ void task_arena_impl::enqueue(d1::task& t, d1::task_arena_base* ta) {
      ta->my_arena->enqueue_task(t, *ta->my_arena->my_default_ctx, *td);
 }
 
+void task_arena_impl::enqueue(d1::task& t, d1::task_arena_base* ta, std::int64_t deadline) {
+    thread_data* td = governor::get_thread_data();
+    assert_pointers_valid(ta, ta->my_arena, ta->my_arena->my_default_ctx, td);
+    __TBB_ASSERT(!ta->my_arena->my_default_ctx->is_group_execution_cancelled(),
+                 "The task will not be executed because default task_group_context of task_arena is cancelled. Has previously enqueued task thrown an exception?");
+    ta->my_arena->enqueue_task(t, *ta->my_arena->my_default_ctx, *td, deadline);
+}
+
 class nested_arena_context : no_copy {
 public:
     nested_arena_context(thread_data& td, arena& nested_arena, std::size_t slot_index)
@@ -484,9 +553,11 @@ public:
             m_orig_arena = td.my_arena;
             m_orig_slot_index = td.my_arena_index;
             m_orig_last_observer = td.my_last_observer;
+            m_orig_last_observer_epoch = td.my_last_observer_epoch;
 
             td.detach_task_dispatcher();
             td.attach_arena(nested_arena, slot_index);
+            RECORD_TRACE_EVENT(td, arena_join, slot_index);
             task_dispatcher& task_disp = td.my_arena_slot->default_task_dispatcher();
             task_disp.set_stealing_threshold(m_orig_execute_data_ext.task_disp->m_stealing_threshold);
             td.attach_task_dispatcher(task_disp);
@@ -494,12 +565,13 @@ public:
             // If the calling thread occupies the slots out of master reserve we need to notify the
             // market that this arena requires one worker less.
             if (td.my_arena_index >= td.my_arena->my_num_reserved_slots) {
-                td.my_arena->my_market->adjust_demand(*td.my_arena, -1);
+                td.my_arena->on_external_thread_enter_worker_slot();
             }
 
             td.my_last_observer = nullptr;
+            td.my_last_observer_epoch = 0;
             // The task_arena::execute method considers each calling thread as a master.
-            td.my_arena->my_observers.notify_entry_observers(td.my_last_observer, /* worker*/false);
+            td.my_arena->my_observers.notify_entry_observers(td.my_last_observer, td.my_last_observer_epoch, /* worker*/false);
         }
 
         m_task_dispatcher = td.my_task_dispatcher;
@@ -526,15 +598,17 @@ public:
         if (m_orig_arena) {
             td.my_arena->my_observers.notify_exit_observers(td.my_last_observer, /*worker*/ false);
             td.my_last_observer = m_orig_last_observer;
+            td.my_last_observer_epoch = m_orig_last_observer_epoch;
 
             // Notify the market that this thread releasing a one slot
             // that can be used by a worker thread.
             if (td.my_arena_index >= td.my_arena->my_num_reserved_slots) {
-                td.my_arena->my_market->adjust_demand(*td.my_arena, 1);
+                td.my_arena->on_external_thread_leave_worker_slot();
             }
 
             td.my_task_dispatcher->set_stealing_threshold(0);
             td.detach_task_dispatcher();
+            RECORD_TRACE_EVENT(td, arena_leave, td.my_arena_index);
             td.my_arena_slot->release();
             td.my_arena->my_exit_monitors.notify_one(); // do not relax!
 
@@ -548,6 +622,7 @@ private:
     execution_data_ext    m_orig_execute_data_ext{};
     arena*              m_orig_arena{ nullptr };
     observer_proxy*     m_orig_last_observer{ nullptr };
+    std::uintptr_t      m_orig_last_observer_epoch{ 0 };
     task_dispatcher*    m_task_dispatcher{ nullptr };
     unsigned            m_orig_slot_index{};
     bool                m_orig_fifo_tasks_allowed{};
@@ -605,52 +680,20 @@ void task_arena_impl::execute(d1::task_arena_base& ta, d1::delegate_base& d) {
     thread_data* td = governor::get_thread_data();
 
     bool same_arena = td->my_arena == ta.my_arena;
-    std::size_t index1 = td->my_arena_index;
+    std::size_t index = td->my_arena_index;
     if (!same_arena) {
-        index1 = ta.my_arena->occupy_free_slot</*as_worker */false>(*td);
-        if (index1 == arena::out_of_arena) {
-            concurrent_monitor::thread_context waiter;
-            d1::wait_context wo(1);
-            d1::task_group_context exec_context(d1::task_group_context::isolated);
-            task_group_context_impl::copy_fp_settings(exec_context, *ta.my_arena->my_default_ctx);
-
-            delegated_task dt(d, ta.my_arena->my_exit_monitors, wo);
-            ta.my_arena->enqueue_task( dt, exec_context, *td);
-            size_t index2 = arena::out_of_arena;
-            do {
-                ta.my_arena->my_exit_monitors.prepare_wait(waiter, (std::uintptr_t)&d);
-                if (!wo.continue_execution()) {
-                    ta.my_arena->my_exit_monitors.cancel_wait(waiter);
-                    break;
-                }
-                index2 = ta.my_arena->occupy_free_slot</*as_worker*/false>(*td);
-                if (index2 != arena::out_of_arena) {
-                    ta.my_arena->my_exit_monitors.cancel_wait(waiter);
-                    nested_arena_context scope(*td, *ta.my_arena, index2 );
-                    r1::wait(wo, exec_context);
-                    __TBB_ASSERT(!exec_context.my_exception, NULL); // exception can be thrown above, not deferred
-                    break;
-                }
-                ta.my_arena->my_exit_monitors.commit_wait(waiter);
-            } while (wo.continue_execution());
-            if (index2 == arena::out_of_arena) {
-                // notify a waiting thread even if this thread did not enter arena,
-                // in case it was woken by a leaving thread but did not need to enter
-                ta.my_arena->my_exit_monitors.notify_one(); // do not relax!
-            }
-            // process possible exception
-            if (exec_context.my_exception) {
-                __TBB_ASSERT(exec_context.is_group_execution_cancelled(), "The task group context with an exception should be canceled.");
-                exec_context.my_exception->throw_self();
-            }
-            __TBB_ASSERT(governor::is_thread_data_set(td), nullptr);
+        // Fast path: claim a free slot and run the functor inline on the calling thread.
+        // Neither a task is allocated nor the exit monitor is waited on.
+        index = ta.my_arena->occupy_free_slot</*as_worker */false>(*td);
+        if (index == arena::out_of_arena) {
+            execute_delegated(*td, *ta.my_arena, d);
             return;
-        } // if (index1 == arena::out_of_arena)
-    } // if (!same_arena)
+        }
+    }
 
     context_guard_helper</*report_tasks=*/false> context_guard;
     context_guard.set_ctx(ta.my_arena->my_default_ctx);
-    nested_arena_context scope(*td, *ta.my_arena, index1);
+    nested_arena_context scope(*td, *ta.my_arena, index);
 #if _WIN64
     try {
 #endif
@@ -664,6 +707,47 @@ void task_arena_impl::execute(d1::task_arena_base& ta, d1::delegate_base& d) {
 #endif
 }
 
+void task_arena_impl::execute_delegated(thread_data& td, arena& a, d1::delegate_base& d) {
+    // All slots are occupied, so the functor is wrapped into a task that is enqueued into the arena.
+    // The calling thread waits for its completion unless a slot is released in the meantime.
+    a.my_num_delegated_executions.fetch_add(1, std::memory_order_relaxed);
+    concurrent_monitor::thread_context waiter;
+    d1::wait_context wo(1);
+    d1::task_group_context exec_context(d1::task_group_context::isolated);
+    task_group_context_impl::copy_fp_settings(exec_context, *a.my_default_ctx);
+
+    delegated_task dt(d, a.my_exit_monitors, wo);
+    a.enqueue_task( dt, exec_context, td);
+    size_t index = arena::out_of_arena;
+    do {
+        a.my_exit_monitors.prepare_wait(waiter, (std::uintptr_t)&d);
+        if (!wo.continue_execution()) {
+            a.my_exit_monitors.cancel_wait(waiter);
+            break;
+        }
+        index = a.occupy_free_slot</*as_worker*/false>(td);
+        if (index != arena::out_of_arena) {
+            a.my_exit_monitors.cancel_wait(waiter);
+            nested_arena_context scope(td, a, index);
+            r1::wait(wo, exec_context);
+            __TBB_ASSERT(!exec_context.my_exception, NULL); // exception can be thrown above, not deferred
+            break;
+        }
+        a.my_exit_monitors.commit_wait(waiter);
+    } while (wo.continue_execution());
+    if (index == arena::out_of_arena) {
+        // notify a waiting thread even if this thread did not enter arena,
+        // in case it was woken by a leaving thread but did not need to enter
+        a.my_exit_monitors.notify_one(); // do not relax!
+    }
+    // process possible exception
+    if (exec_context.my_exception) {
+        __TBB_ASSERT(exec_context.is_group_execution_cancelled(), "The task group context with an exception should be canceled.");
+        exec_context.my_exception->throw_self();
+    }
+    __TBB_ASSERT(governor::is_thread_data_set(&td), nullptr);
+}
+
 void task_arena_impl::wait(d1::task_arena_base& ta) {
     __TBB_ASSERT(ta.my_arena != nullptr, nullptr);
     thread_data* td = governor::get_thread_data();
@@ -696,6 +780,25 @@ int task_arena_impl::max_concurrency(const d1::task_arena_base *ta) {
     return int(governor::default_num_threads());
 }
 
+bool task_arena_impl::query_statistics(const d1::task_arena_base& ta, d1::arena_statistics& stats) {
+    stats = d1::arena_statistics{};
+    arena* a = ta.my_arena;
+    __TBB_ASSERT(a, "The arena must be initialized to query its statistics");
+    // The arena-wide counters are maintained in any configuration
+    stats.delegated_executions = a->my_num_delegated_executions.load(std::memory_order_relaxed);
+    stats.missed_deadlines = a->my_num_missed_deadlines.load(std::memory_order_relaxed);
+#if __TBB_STATISTICS
+    // The counters are read without synchronization with the slot owners,
+    // so the result is a snapshot that can be slightly behind the actual activity.
+    for (unsigned i = 0; i < a->my_num_slots; ++i) {
+        a->my_slots[i].statistics().accumulate(stats);
+    }
+    return true;
+#else
+    return false;
+#endif /* __TBB_STATISTICS */
+}
+
 void isolate_within_arena(d1::delegate_base& d, std::intptr_t isolation) {
     // TODO: Decide what to do if the scheduler is not initialized. Is there a use case for it?
     thread_data* tls = governor::get_thread_data();
@@ -25,6 +25,7 @@
 #include "scheduler_common.h"
 #include "intrusive_list.h"
 #include "task_stream.h"
+#include "deadline_task_stream.h"
 #include "arena_slot.h"
 #include "rml_tbb.h"
 #include "mailbox.h"
@@ -168,6 +169,17 @@ struct arena_base : padded<intrusive_list_node> {
     task_stream<back_nonnull_accessor> my_critical_task_stream;
 #endif
 
+    //! Task pool for the tasks spawned with low priority.
+    /** Low priority tasks are taken only when the thread has found nothing to steal. **/
+    task_stream<back_nonnull_accessor> my_low_priority_task_stream;
+
+    //! Task pool for the tasks enqueued with a deadline.
+    /** The tasks are taken in the earliest-deadline-first order ahead of the FIFO enqueued tasks. **/
+    deadline_task_stream my_deadline_task_stream;
+
+    //! The number of tasks with a deadline that were taken for execution after their deadline
+    std::atomic<std::uint64_t> my_num_missed_deadlines;
+
     //! The number of workers requested by the master thread owning the arena.
     unsigned my_max_num_workers;
 
@@ -178,6 +190,14 @@ struct arena_base : padded<intrusive_list_node> {
     //! Possible values are in [0, my_max_num_workers]
     int my_num_workers_requested;
 
+    //! The number of the worker slots occupied by external threads and not yet subtracted from the demand
+    /** While the arena has no work, task_arena::execute does not ask the market to decrease the
+        demand for the worker slot it occupies; the decrease is passed with the next demand increase. **/
+    std::atomic<int> my_num_deferred_external_slots;
+
+    //! The number of task_arena::execute calls that found no free slot and were delegated to the arena
+    std::atomic<std::uint64_t> my_num_delegated_executions;
+
     //! The index in the array of per priority lists of arenas this object is in.
     /*const*/ unsigned my_priority_level;
 
@@ -195,9 +215,16 @@ struct arena_base : padded<intrusive_list_node> {
     //! The list of local observers attached to this arena.
     observer_list my_observers;
 
+    //! Moving average of the worker idle gaps, in yields of the stealing loop.
+    /** Updated without synchronization since it only tunes how long workers spin. **/
+    std::atomic<int> my_idle_gap_estimate;
+
 #if __TBB_NUMA_SUPPORT
     //! Pointer to internal observer that allows to bind threads in arena to certain NUMA node.
     numa_binding_observer* my_numa_binding_observer;
+
+    //! Thieves try victims on their own NUMA node before the remote ones.
+    bool my_numa_aware_stealing;
 #endif /*__TBB_NUMA_SUPPORT*/
 
     // Below are rarely modified members
@@ -302,9 +329,32 @@ public:
     //! If necessary, raise a flag that there is new job in arena.
     template<arena::new_work_type work_type> void advertise_new_work();
 
+    //! Decreases the demand for workers when an external thread occupies a worker slot
+    /** The market is not involved while the arena has no work. **/
+    void on_external_thread_enter_worker_slot();
+
+    //! Restores the demand decreased by on_external_thread_enter_worker_slot
+    void on_external_thread_leave_worker_slot();
+
+    //! Takes a deferred demand decrease, if any
+    bool try_take_deferred_external_slot();
+
+    //! Accounts the duration of a worker idle gap in the moving average.
+    void record_idle_gap(int num_yields) {
+        int estimate = my_idle_gap_estimate.load(std::memory_order_relaxed);
+        // New samples have the weight of 1/8
+        my_idle_gap_estimate.store((7 * estimate + num_yields + 4) / 8, std::memory_order_relaxed);
+    }
+
     //! Attempts to steal a task from a randomly chosen arena slot
     d1::task* steal_task(unsigned arena_index, FastRandom& frnd, execution_data_ext& ed, isolation_type isolation);
 
+#if __TBB_NUMA_SUPPORT
+    //! Looks for a slot with shared tasks on the thief's NUMA node, starting from the hint.
+    /** Returns the hint if there is no such slot, so the thief falls back to a remote victim. **/
+    std::size_t numa_local_victim(unsigned arena_index, std::size_t slot_num_limit, std::size_t hint);
+#endif
+
     //! Get a task from a global starvation resistant queue
     template<task_stream_accessor_type accessor>
     d1::task* get_stream_task(task_stream<accessor>& stream, unsigned& hint);
@@ -314,6 +364,12 @@ public:
     d1::task* get_critical_task(unsigned& hint, isolation_type isolation);
 #endif
 
+    //! Tries to find a task in the low priority task stream respecting isolation
+    d1::task* get_low_priority_task(unsigned& hint, isolation_type isolation);
+
+    //! Takes the task with the earliest deadline and counts it if the deadline has already passed
+    d1::task* get_deadline_task();
+
     //! Check if there is job anywhere in arena.
     /** Return true if no job or if arena is being cleaned up. */
     bool is_out_of_work();
@@ -321,6 +377,9 @@ public:
     //! enqueue a task into starvation-resistance queue
     void enqueue_task(d1::task&, d1::task_group_context&, thread_data&);
 
+    //! enqueue a task into the earliest-deadline-first queue
+    void enqueue_task(d1::task&, d1::task_group_context&, thread_data&, std::int64_t deadline);
+
     //! Registers the worker with the arena and enters TBB scheduler dispatch loop
     void process(thread_data&);
 
@@ -503,7 +562,9 @@ void arena::advertise_new_work() {
             }
 #endif /* __TBB_ENQUEUE_ENFORCED_CONCURRENCY */
             // TODO: investigate adjusting of arena's demand by a single worker.
-            my_market->adjust_demand( *this, my_max_num_workers );
+            // The worker slots occupied by external threads are not requested.
+            int num_deferred_slots = my_num_deferred_external_slots.exchange(0);
+            my_market->adjust_demand( *this, int(my_max_num_workers) - num_deferred_slots );
 
             // Notify all sleeping threads that work has appeared in the arena.
             my_market->get_wait_list().notify(is_related_arena);
@@ -511,6 +572,32 @@ void arena::advertise_new_work() {
     }
 }
 
+inline bool arena::try_take_deferred_external_slot() {
+    int num_deferred_slots = my_num_deferred_external_slots.load(std::memory_order_relaxed);
+    while (num_deferred_slots > 0) {
+        if (my_num_deferred_external_slots.compare_exchange_weak(num_deferred_slots, num_deferred_slots - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void arena::on_external_thread_enter_worker_slot() {
+    // The deferred slots are interchangeable: each external thread in a worker slot is counted
+    // either in my_num_deferred_external_slots or in the demand passed to the market.
+    my_num_deferred_external_slots.fetch_add(1);
+    // Pairs with the transition to SNAPSHOT_FULL followed by the exchange in advertise_new_work
+    if (my_pool_state.load() != SNAPSHOT_EMPTY && try_take_deferred_external_slot()) {
+        my_market->adjust_demand(*this, -1);
+    }
+}
+
+inline void arena::on_external_thread_leave_worker_slot() {
+    if (!try_take_deferred_external_slot()) {
+        my_market->adjust_demand(*this, 1);
+    }
+}
+
 inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execution_data_ext& ed, isolation_type isolation) {
     auto slot_num_limit = my_limit.load(std::memory_order_relaxed);
     if (slot_num_limit == 1) {
@@ -527,10 +614,16 @@ inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execu
     if (k >= arena_index) {
         ++k; // Adjusts random distribution to exclude self
     }
+#if __TBB_NUMA_SUPPORT
+    if (my_numa_aware_stealing) {
+        k = numa_local_victim(arena_index, slot_num_limit, k);
+    }
+#endif
     arena_slot* victim = &my_slots[k];
     d1::task **pool = victim->task_pool.load(std::memory_order_relaxed);
     d1::task *t = nullptr;
     if (pool == EmptyTaskPool || !(t = victim->steal_task(*this, isolation))) {
+        GATHER_STATISTIC(my_slots[arena_index].statistics().steal_failed());
         return nullptr;
     }
     if (task_accessor::is_proxy_task(*t)) {
@@ -540,6 +633,8 @@ inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execu
         if (!t) {
             // Proxy was empty, so it's our responsibility to free it
             deallocate(*tp.allocator, &tp, sizeof(task_proxy), ed);
+            GATHER_STATISTIC(my_slots[arena_index].statistics().proxy_dropped());
+            GATHER_STATISTIC(my_slots[arena_index].statistics().steal_failed());
             return nullptr;
         }
         // Note affinity is called for any stealed task (proxy or general)
@@ -550,9 +645,31 @@ inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execu
     }
     // Update task owner thread id to identify stealing
     ed.original_slot = k;
+    GATHER_STATISTIC(my_slots[arena_index].statistics().task_stolen());
     return t;
 }
 
+#if __TBB_NUMA_SUPPORT
+inline std::size_t arena::numa_local_victim(unsigned arena_index, std::size_t slot_num_limit, std::size_t hint) {
+    int numa_node = my_slots[arena_index].numa_node();
+    if (numa_node < 0) {
+        // The location of the thief is unknown, so every victim is as good as any other.
+        return hint;
+    }
+    for (std::size_t k = hint; k < slot_num_limit; ++k) {
+        if (k != arena_index && my_slots[k].numa_node() == numa_node && my_slots[k].is_task_pool_published()) {
+            return k;
+        }
+    }
+    for (std::size_t k = 0; k < hint; ++k) {
+        if (k != arena_index && my_slots[k].numa_node() == numa_node && my_slots[k].is_task_pool_published()) {
+            return k;
+        }
+    }
+    return hint;
+}
+#endif /*__TBB_NUMA_SUPPORT*/
+
 template<task_stream_accessor_type accessor>
 inline d1::task* arena::get_stream_task(task_stream<accessor>& stream, unsigned& hint) {
     if (stream.empty())
@@ -579,6 +696,26 @@ inline d1::task* arena::get_critical_task(unsigned& hint, isolation_type isolati
 }
 #endif // __TBB_PREVIEW_CRITICAL_TASKS
 
+inline d1::task* arena::get_low_priority_task(unsigned& hint, isolation_type isolation) {
+    if (my_low_priority_task_stream.empty())
+        return nullptr;
+
+    if (isolation != no_isolation) {
+        return my_low_priority_task_stream.pop_specific(hint, isolation);
+    } else {
+        return my_low_priority_task_stream.pop(preceding_lane_selector(hint));
+    }
+}
+
+inline d1::task* arena::get_deadline_task() {
+    std::int64_t deadline = 0;
+    d1::task* t = my_deadline_task_stream.pop(deadline);
+    if (t && deadline < deadline_clock_now()) {
+        my_num_missed_deadlines.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t;
+}
+
 } // namespace r1
 } // namespace detail
 } // namespace tbb
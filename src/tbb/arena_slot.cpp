@@ -51,6 +51,7 @@ d1::task* arena_slot::get_task_impl(size_t T, execution_data_ext& ed, bool& task
     }
     // Proxy was empty, so it's our responsibility to free it
     deallocate(*tp.allocator, &tp, sizeof(task_proxy), ed);
+    GATHER_STATISTIC(my_statistics.proxy_dropped());
 
     if ( tasks_omitted ) {
         task_pool_ptr[T] = nullptr;
@@ -27,6 +27,7 @@
 #include "misc.h"
 #include "mailbox.h"
 #include "scheduler_common.h"
+#include "statistics.h"
 
 #include <atomic>
 
@@ -58,6 +59,12 @@ struct alignas(max_nfs_size) arena_slot_shared_state {
     //! Index of the first ready task in the deque.
     /** Modified by thieves, and by the owner during compaction/reallocation **/
     std::atomic<std::size_t> head;
+
+#if __TBB_NUMA_SUPPORT
+    //! NUMA node of the thread attached to the slot (-1 if unknown)
+    /** Set by the owner on arena entry, read by thieves of NUMA-aware arenas **/
+    std::atomic<int> my_numa_node;
+#endif
 };
 
 struct alignas(max_nfs_size) arena_slot_private_state {
@@ -73,6 +80,9 @@ struct alignas(max_nfs_size) arena_slot_private_state {
     //! Similar to 'hint_for_fifo_stream' but for the resume tasks.
     unsigned hint_for_resume_stream;
 
+    //! Similar to 'hint_for_fifo_stream' but for the low priority tasks.
+    unsigned hint_for_low_priority_stream;
+
     //! Index of the element following the last ready task in the deque.
     /** Modified by the owner thread. **/
     std::atomic<std::size_t> tail;
@@ -83,6 +93,11 @@ struct alignas(max_nfs_size) arena_slot_private_state {
     //! Task pool of the scheduler that owns this slot
     // TODO: previously was task**__TBB_atomic, but seems like not accessed on other thread
     d1::task** task_pool_ptr;
+
+#if __TBB_STATISTICS
+    //! Scheduler activity counters of the threads occupying the slot
+    slot_statistics my_statistics;
+#endif
 };
 
 class arena_slot : private arena_slot_shared_state, private arena_slot_private_state {
@@ -163,6 +178,22 @@ public:
         if (!is_task_pool_published()) {
             publish_task_pool();
         }
+        GATHER_STATISTIC(my_statistics.task_spawned());
+    }
+
+    //! Pushes several tasks into the local task pool making them visible to thieves at once
+    void spawn(d1::task* const* tasks, std::size_t num_tasks) {
+        __TBB_ASSERT(num_tasks > 0, nullptr);
+        std::size_t T = prepare_task_pool(num_tasks);
+        for (std::size_t i = 0; i < num_tasks; ++i) {
+            __TBB_ASSERT(is_poisoned(task_pool_ptr[T + i]), NULL);
+            task_pool_ptr[T + i] = tasks[i];
+        }
+        commit_spawned_tasks(T + num_tasks);
+        if (!is_task_pool_published()) {
+            publish_task_pool();
+        }
+        GATHER_STATISTIC(my_statistics.task_spawned(num_tasks));
     }
 
     bool is_task_pool_published() const {
@@ -173,6 +204,26 @@ public:
         return my_is_occupied.load(std::memory_order_relaxed);
     }
 
+#if __TBB_STATISTICS
+    slot_statistics& statistics() {
+        return my_statistics;
+    }
+
+    const slot_statistics& statistics() const {
+        return my_statistics;
+    }
+#endif
+
+#if __TBB_NUMA_SUPPORT
+    int numa_node() const {
+        return my_numa_node.load(std::memory_order_relaxed);
+    }
+
+    void set_numa_node(int numa_id) {
+        my_numa_node.store(numa_id, std::memory_order_relaxed);
+    }
+#endif
+
     task_dispatcher& default_task_dispatcher() {
         __TBB_ASSERT(my_default_task_dispatcher != nullptr, nullptr);
         return *my_default_task_dispatcher;
@@ -186,6 +237,7 @@ public:
 #if __TBB_PREVIEW_CRITICAL_TASKS
         hint_for_critical_stream = h;
 #endif
+        hint_for_low_priority_stream = h;
     }
 
 #if __TBB_PREVIEW_CRITICAL_TASKS
@@ -193,6 +245,10 @@ public:
         return hint_for_critical_stream;
     }
 #endif
+
+    unsigned& low_priority_hint() {
+        return hint_for_low_priority_stream;
+    }
 private:
     //! Get a task from the local pool at specified location T.
     /** Returns the pointer to the task or NULL if the task cannot be executed,
@@ -0,0 +1,193 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "co_stack_pool.h"
+#include "governor.h"
+#include "thread_data.h"
+#include "arena_slot.h"
+
+#if __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64)
+#include <sys/mman.h> // mmap, mprotect
+
+#ifndef MAP_STACK
+// macOS* does not define MAP_STACK
+#define MAP_STACK 0
+#endif
+#ifndef MAP_ANONYMOUS
+// macOS* defines MAP_ANON, which is deprecated in Linux*.
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif /* __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64) */
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+#if __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64)
+co_stack_pool the_co_stack_pool;
+
+//! Maps the page aligned stack with a guard page on each side
+static void* map_stack(std::size_t stack_size) {
+    const std::size_t page_size = governor::default_page_size();
+    const std::size_t protected_stack_size = stack_size + 2 * page_size;
+
+    // Allocate the stack with protection property
+    std::uintptr_t stack_ptr = (std::uintptr_t)mmap(NULL, protected_stack_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    __TBB_ASSERT((void*)stack_ptr != MAP_FAILED, NULL);
+
+    // Allow read write on our stack (guarded pages are still protected)
+    int err = mprotect((void*)(stack_ptr + page_size), stack_size, PROT_READ | PROT_WRITE);
+    __TBB_ASSERT_EX(!err, NULL);
+    return (void*)(stack_ptr + page_size);
+}
+
+static void unmap_stack(void* stack, std::size_t stack_size) {
+    const std::size_t page_size = governor::default_page_size();
+    // Free stack memory with guarded pages
+    munmap((void*)((std::uintptr_t)stack - page_size), stack_size + 2 * page_size);
+}
+
+std::size_t co_stack_pool::size_class(std::size_t stack_size) {
+    const std::size_t page_size = governor::default_page_size();
+    const std::size_t num_pages = (stack_size + page_size - 1) / page_size;
+    std::size_t c = 0;
+    while (c < num_size_classes && (std::size_t(1) << c) < num_pages) {
+        ++c;
+    }
+    return c;
+}
+
+std::size_t co_stack_pool::bucket_index(int numa_node) {
+    return numa_node < 0 ? 0 : 1 + std::size_t(numa_node) % max_numa_nodes;
+}
+
+void* co_stack_pool::allocate(std::size_t& stack_size, int& numa_node) {
+    const std::size_t page_size = governor::default_page_size();
+    thread_data* td = governor::get_thread_data_if_initialized();
+    numa_node = td && td->my_arena_slot ? td->my_arena_slot->numa_node() : -1;
+
+    const std::size_t c = size_class(stack_size);
+    if (c < num_size_classes) {
+        stack_size = page_size << c;
+        bucket& b = my_buckets[bucket_index(numa_node)][c];
+        cached_stack* s = nullptr;
+        {
+            spin_mutex::scoped_lock lock(b.mutex);
+            s = b.head;
+            if (s) {
+                b.head = s->next;
+            }
+        }
+        if (s) {
+            my_cached_bytes.fetch_sub(stack_size, std::memory_order_relaxed);
+            my_stacks_cached.fetch_sub(1, std::memory_order_relaxed);
+            my_stacks_reused.fetch_add(1, std::memory_order_relaxed);
+            return s;
+        }
+    } else {
+        // Too large to be cached
+        stack_size = (stack_size + page_size - 1) & ~(page_size - 1);
+    }
+    my_stacks_allocated.fetch_add(1, std::memory_order_relaxed);
+    return map_stack(stack_size);
+}
+
+void co_stack_pool::deallocate(void* stack, std::size_t stack_size, int numa_node) {
+    const std::size_t c = size_class(stack_size);
+    if (c < num_size_classes && (governor::default_page_size() << c) == stack_size) {
+        // Reserve the place in the cache first, so concurrent deallocations do not exceed the limit
+        std::size_t cached_bytes = my_cached_bytes.fetch_add(stack_size, std::memory_order_relaxed) + stack_size;
+        if (cached_bytes <= my_limit.load(std::memory_order_relaxed)) {
+            // The link is kept at the bottom of the stack, which is the last to be touched
+            cached_stack* s = static_cast<cached_stack*>(stack);
+            bucket& b = my_buckets[bucket_index(numa_node)][c];
+            {
+                spin_mutex::scoped_lock lock(b.mutex);
+                s->next = b.head;
+                b.head = s;
+            }
+            my_stacks_cached.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        my_cached_bytes.fetch_sub(stack_size, std::memory_order_relaxed);
+    }
+    my_stacks_released.fetch_add(1, std::memory_order_relaxed);
+    unmap_stack(stack, stack_size);
+}
+
+void co_stack_pool::set_limit(std::size_t limit) {
+    my_limit.store(limit, std::memory_order_relaxed);
+    trim();
+}
+
+void co_stack_pool::trim() {
+    // Release the largest stacks first
+    for (std::size_t c = num_size_classes; c-- > 0;) {
+        const std::size_t stack_size = governor::default_page_size() << c;
+        for (std::size_t n = 0; n <= max_numa_nodes; ++n) {
+            bucket& b = my_buckets[n][c];
+            while (my_cached_bytes.load(std::memory_order_relaxed) > my_limit.load(std::memory_order_relaxed)) {
+                cached_stack* s = nullptr;
+                {
+                    spin_mutex::scoped_lock lock(b.mutex);
+                    s = b.head;
+                    if (s) {
+                        b.head = s->next;
+                    }
+                }
+                if (!s) {
+                    break;
+                }
+                my_cached_bytes.fetch_sub(stack_size, std::memory_order_relaxed);
+                my_stacks_cached.fetch_sub(1, std::memory_order_relaxed);
+                my_stacks_released.fetch_add(1, std::memory_order_relaxed);
+                unmap_stack(s, stack_size);
+            }
+        }
+    }
+}
+
+void co_stack_pool::get_statistics(d1::coroutine_stack_statistics& stats) const {
+    stats.stacks_allocated = my_stacks_allocated.load(std::memory_order_relaxed);
+    stats.stacks_reused = my_stacks_reused.load(std::memory_order_relaxed);
+    stats.stacks_released = my_stacks_released.load(std::memory_order_relaxed);
+    stats.stacks_cached = my_stacks_cached.load(std::memory_order_relaxed);
+    stats.cached_bytes = my_cached_bytes.load(std::memory_order_relaxed);
+}
+#endif /* __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64) */
+
+void set_co_stack_cache_limit(std::size_t limit) {
+#if __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64)
+    the_co_stack_pool.set_limit(limit);
+#else
+    // The fiber stacks are managed by the system
+    suppress_unused_warning(limit);
+#endif
+}
+
+bool __TBB_EXPORTED_FUNC query_coroutine_stack_statistics(d1::coroutine_stack_statistics& stats) {
+    stats = d1::coroutine_stack_statistics{};
+#if __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64)
+    the_co_stack_pool.get_statistics(stats);
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
@@ -0,0 +1,97 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_co_stack_pool_H
+#define _TBB_co_stack_pool_H
+
+#include "oneapi/tbb/detail/_config.h"
+#include "oneapi/tbb/detail/_task.h"
+#include "oneapi/tbb/detail/_utils.h"
+#include "oneapi/tbb/spin_mutex.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! The default maximal total size in bytes of the cached coroutine stacks
+constexpr std::size_t default_co_stack_cache_size = std::size_t(sizeof(void*) > 4 ? 256 : 32) << 20;
+
+#if __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64)
+//! Process-wide cache of the coroutine stacks
+/** The stacks are kept per NUMA node where they were mapped and per size class, so a suspended
+    task usually gets a stack whose pages are already placed on the node of its thread. A size
+    class holds the stacks of a power of two number of pages. The guard pages around a stack stay
+    protected while it is cached. The cached stacks are returned to the system when the cache grows
+    over the limit set by global_control::coroutine_stack_cache_size. **/
+class co_stack_pool {
+public:
+    static constexpr std::size_t num_size_classes = 20;
+    //! The stacks of the threads with unknown NUMA node are kept separately
+    static constexpr std::size_t max_numa_nodes = 8;
+
+    //! Returns a stack of at least stack_size bytes surrounded by the guard pages
+    /** The stack_size is updated with the usable size of the returned stack, and numa_node is set
+        to the NUMA node of the calling thread, which the stack is to be returned to. **/
+    void* allocate(std::size_t& stack_size, int& numa_node);
+
+    //! Caches the stack or returns it to the system if the cache is full
+    void deallocate(void* stack, std::size_t stack_size, int numa_node);
+
+    //! Sets the maximal total size of the cached stacks and releases the excess
+    void set_limit(std::size_t limit);
+
+    void get_statistics(d1::coroutine_stack_statistics& stats) const;
+
+private:
+    struct cached_stack {
+        cached_stack* next;
+    };
+
+    struct alignas(max_nfs_size) bucket {
+        spin_mutex mutex;
+        cached_stack* head{nullptr};
+    };
+
+    static std::size_t size_class(std::size_t stack_size);
+    static std::size_t bucket_index(int numa_node);
+    //! Releases the cached stacks until the cache fits the limit
+    void trim();
+
+    bucket my_buckets[max_numa_nodes + 1][num_size_classes];
+    std::atomic<std::size_t> my_cached_bytes{0};
+    std::atomic<std::size_t> my_limit{default_co_stack_cache_size};
+
+    std::atomic<std::uint64_t> my_stacks_allocated{0};
+    std::atomic<std::uint64_t> my_stacks_reused{0};
+    std::atomic<std::uint64_t> my_stacks_released{0};
+    std::atomic<std::uint64_t> my_stacks_cached{0};
+};
+
+extern co_stack_pool the_co_stack_pool;
+#endif /* __TBB_RESUMABLE_TASKS && !(_WIN32 || _WIN64) */
+
+//! Applies the coroutine_stack_cache_size global control
+void set_co_stack_cache_limit(std::size_t limit);
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_co_stack_pool_H */
@@ -0,0 +1,102 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_deadline_task_stream_H
+#define _TBB_deadline_task_stream_H
+
+#include "oneapi/tbb/detail/_utils.h"
+
+#include "oneapi/tbb/spin_mutex.h"
+#include "oneapi/tbb/cache_aligned_allocator.h"
+
+#include "scheduler_common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! Returns the current time in the representation of the task deadlines
+inline std::int64_t deadline_clock_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//! The pool of the enqueued tasks ordered by their deadlines.
+/** Unlike task_stream, the tasks are not spread over lanes: the earliest deadline has to be
+    found among all the tasks, so a single heap protected by a mutex is used. **/
+class alignas(max_nfs_size) deadline_task_stream : no_copy {
+    struct item {
+        std::int64_t deadline;
+        d1::task* task;
+    };
+
+    //! Makes the heap a min-heap with respect to the deadlines
+    struct later_deadline {
+        bool operator()(const item& lhs, const item& rhs) const {
+            return lhs.deadline > rhs.deadline;
+        }
+    };
+
+    using heap_type = std::vector<item, cache_aligned_allocator<item>>;
+
+    heap_type my_heap{};
+    spin_mutex my_mutex{};
+    //! The number of tasks in the heap, checked without the lock
+    std::atomic<std::size_t> my_size{0};
+
+public:
+    //! Adds the task with the given deadline
+    void push(d1::task* t, std::int64_t deadline) {
+        spin_mutex::scoped_lock lock(my_mutex);
+        my_heap.push_back(item{deadline, t});
+        std::push_heap(my_heap.begin(), my_heap.end(), later_deadline{});
+        my_size.store(my_heap.size(), std::memory_order_release);
+    }
+
+    //! Takes the task with the earliest deadline, if any
+    d1::task* pop(std::int64_t& deadline) {
+        if (empty()) {
+            return nullptr;
+        }
+        spin_mutex::scoped_lock lock(my_mutex);
+        if (my_heap.empty()) {
+            return nullptr;
+        }
+        std::pop_heap(my_heap.begin(), my_heap.end(), later_deadline{});
+        item result = my_heap.back();
+        my_heap.pop_back();
+        my_size.store(my_heap.size(), std::memory_order_release);
+        deadline = result.deadline;
+        return result.task;
+    }
+
+    //! Checks if the stream has no tasks. The result can be stale.
+    bool empty() const {
+        return my_size.load(std::memory_order_relaxed) == 0;
+    }
+};
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_deadline_task_stream_H */
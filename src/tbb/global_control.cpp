@@ -21,6 +21,7 @@
 #include "oneapi/tbb/tbb_allocator.h"
 #include "oneapi/tbb/spin_mutex.h"
 
+#include "co_stack_pool.h"
 #include "governor.h"
 #include "market.h"
 #include "misc.h"
@@ -105,6 +106,61 @@ class alignas(max_nfs_size) terminate_on_exception_control : public control_stor
     }
 };
 
+//! The active wait policy, cached for the stealing loop that cannot afford locking my_list_mutex
+static std::atomic<std::size_t> the_wait_policy{global_control::wait_balanced};
+
+class alignas(max_nfs_size) wait_policy_control : public control_storage {
+    virtual std::size_t default_value() const override {
+        return global_control::wait_balanced;
+    }
+    virtual bool is_first_arg_preferred(std::size_t a, std::size_t b) const override {
+        return a<b; // prefer the most latency-oriented policy
+    }
+    virtual void apply_active(std::size_t new_active) override {
+        control_storage::apply_active(new_active);
+        the_wait_policy.store(new_active, std::memory_order_relaxed);
+    }
+};
+
+//! The active allotment policy, cached for the stealing loop as well
+static std::atomic<std::size_t> the_allotment_policy{global_control::allotment_responsive};
+
+class alignas(max_nfs_size) allotment_policy_control : public control_storage {
+    virtual std::size_t default_value() const override {
+        return global_control::allotment_responsive;
+    }
+    virtual bool is_first_arg_preferred(std::size_t a, std::size_t b) const override {
+        return a<b; // prefer the most responsive policy
+    }
+    virtual void apply_active(std::size_t new_active) override {
+        control_storage::apply_active(new_active);
+        the_allotment_policy.store(new_active, std::memory_order_relaxed);
+    }
+};
+
+class alignas(max_nfs_size) co_stack_cache_size_control : public control_storage {
+    virtual std::size_t default_value() const override {
+        return default_co_stack_cache_size;
+    }
+    virtual bool is_first_arg_preferred(std::size_t a, std::size_t b) const override {
+        return a<b; // prefer the smallest cache
+    }
+    virtual void apply_active(std::size_t new_active) override {
+        control_storage::apply_active(new_active);
+        set_co_stack_cache_limit(new_active);
+    }
+};
+
+#if !__TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
+//! Storage of the parameter that has no effect in this configuration.
+/** The controls of the parameter are still tracked, so creating and destroying them is harmless. */
+class alignas(max_nfs_size) reserved_control : public control_storage {
+    virtual std::size_t default_value() const override {
+        return 0;
+    }
+};
+#endif // !__TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
+
 #if __TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
 class alignas(max_nfs_size) lifetime_control : public control_storage {
     virtual bool is_first_arg_preferred(std::size_t, std::size_t) const override {
@@ -142,11 +198,18 @@ public:
 static allowed_parallelism_control allowed_parallelism_ctl;
 static stack_size_control stack_size_ctl;
 static terminate_on_exception_control terminate_on_exception_ctl;
+static wait_policy_control wait_policy_ctl;
+static allotment_policy_control allotment_policy_ctl;
+static co_stack_cache_size_control co_stack_cache_size_ctl;
 #if __TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
 static lifetime_control lifetime_ctl;
-static control_storage *controls[] = {&allowed_parallelism_ctl, &stack_size_ctl, &terminate_on_exception_ctl, &lifetime_ctl};
+static control_storage *controls[] = {&allowed_parallelism_ctl, &stack_size_ctl, &terminate_on_exception_ctl, &lifetime_ctl,
+                                      &wait_policy_ctl, &allotment_policy_ctl, &co_stack_cache_size_ctl};
 #else
-static control_storage *controls[] = {&allowed_parallelism_ctl, &stack_size_ctl, &terminate_on_exception_ctl};
+// reserved1 is not a public parameter, but a control for it must not dereference a null storage
+static reserved_control reserved_ctl;
+static control_storage *controls[] = {&allowed_parallelism_ctl, &stack_size_ctl, &terminate_on_exception_ctl, &reserved_ctl,
+                                      &wait_policy_ctl, &allotment_policy_ctl, &co_stack_cache_size_ctl};
 #endif // __TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
 
 //! Comparator for a set of global_control objects
@@ -163,6 +226,14 @@ bool terminate_on_exception() {
     return global_control::active_value(global_control::terminate_on_exception) == 1;
 }
 
+std::size_t wait_policy() {
+    return the_wait_policy.load(std::memory_order_relaxed);
+}
+
+std::size_t allotment_policy() {
+    return the_allotment_policy.load(std::memory_order_relaxed);
+}
+
 #if __TBB_SUPPORTS_WORKERS_WAITING_IN_TERMINATE
 unsigned market::is_lifetime_control_present() {
     return !lifetime_ctl.is_empty();
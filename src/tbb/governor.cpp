@@ -168,6 +168,7 @@ void governor::init_external_thread() {
     // Master thread always occupies the first slot
     thread_data& td = *new(cache_aligned_allocate(sizeof(thread_data))) thread_data(0, false);
     td.attach_arena(a, /*slot index*/ 0);
+    RECORD_TRACE_EVENT(td, arena_join, 0);
 
     stack_size = a.my_market->worker_stack_size();
     std::uintptr_t stack_base = get_stack_base(stack_size);
@@ -195,6 +196,7 @@ void governor::auto_terminate(void* tls) {
 
             td->my_task_dispatcher->m_stealing_threshold = 0;
             td->detach_task_dispatcher();
+            RECORD_TRACE_EVENT(*td, arena_leave, td->my_arena_index);
             td->my_arena_slot->release();
             // Release an arena
             a->on_thread_leaving<arena::ref_external>();
@@ -277,7 +279,9 @@ bool __TBB_EXPORTED_FUNC finalize(d1::task_scheduler_handle& handle, std::intptr
 #pragma weak __TBB_internal_allocate_binding_handler
 #pragma weak __TBB_internal_deallocate_binding_handler
 #pragma weak __TBB_internal_bind_to_node
+#pragma weak __TBB_internal_bind_to_core
 #pragma weak __TBB_internal_restore_affinity
+#pragma weak __TBB_internal_get_current_numa_node
 
 extern "C" {
 void __TBB_internal_initialize_numa_topology(
@@ -288,7 +292,10 @@ binding_handler* __TBB_internal_allocate_binding_handler( int slot_num );
 void __TBB_internal_deallocate_binding_handler( binding_handler* handler_ptr );
 
 void __TBB_internal_bind_to_node( binding_handler* handler_ptr, int slot_num, int numa_id );
+void __TBB_internal_bind_to_core( binding_handler* handler_ptr, int slot_num, int numa_id, int policy );
 void __TBB_internal_restore_affinity( binding_handler* handler_ptr, int slot_num );
+
+int __TBB_internal_get_current_numa_node();
 }
 #endif /* __TBB_WEAK_SYMBOLS_PRESENT */
 
@@ -302,8 +309,11 @@ static binding_handler* (*allocate_binding_handler_ptr)( int slot_num ) = NULL;
 static void (*deallocate_binding_handler_ptr)( binding_handler* handler_ptr ) = NULL;
 
 static void (*bind_to_node_ptr)( binding_handler* handler_ptr, int slot_num, int numa_id ) = NULL;
+static void (*bind_to_core_ptr)( binding_handler* handler_ptr, int slot_num, int numa_id, int policy ) = NULL;
 static void (*restore_affinity_ptr)( binding_handler* handler_ptr, int slot_num ) = NULL;
 
+static int (*get_current_numa_node_ptr)() = NULL;
+
 #if _WIN32 || _WIN64 || __linux__
 // Table describing how to link the handlers.
 static const dynamic_link_descriptor TbbBindLinkTable[] = {
@@ -311,10 +321,12 @@ static const dynamic_link_descriptor TbbBindLinkTable[] = {
     DLD(__TBB_internal_allocate_binding_handler, allocate_binding_handler_ptr),
     DLD(__TBB_internal_deallocate_binding_handler, deallocate_binding_handler_ptr),
     DLD(__TBB_internal_bind_to_node, bind_to_node_ptr),
-    DLD(__TBB_internal_restore_affinity, restore_affinity_ptr)
+    DLD(__TBB_internal_bind_to_core, bind_to_core_ptr),
+    DLD(__TBB_internal_restore_affinity, restore_affinity_ptr),
+    DLD(__TBB_internal_get_current_numa_node, get_current_numa_node_ptr)
 };
 
-static const unsigned LinkTableSize = 5;
+static const unsigned LinkTableSize = 7;
 
 #if TBB_USE_DEBUG
 #define DEBUG_SUFFIX "_debug"
@@ -333,7 +345,9 @@ static const unsigned LinkTableSize = 5;
 static binding_handler* dummy_allocate_binding_handler ( int ) { return NULL; }
 static void dummy_deallocate_binding_handler ( binding_handler* ) { }
 static void dummy_bind_to_node ( binding_handler*, int, int ) { }
+static void dummy_bind_to_core ( binding_handler*, int, int, int ) { }
 static void dummy_restore_affinity ( binding_handler*, int ) { }
+static int dummy_get_current_numa_node () { return -1; }
 
 // Representation of NUMA topology information on the TBB side.
 // NUMA topology may be initialized by third-party component (e.g. hwloc)
@@ -390,7 +404,9 @@ void initialization_impl() {
     deallocate_binding_handler_ptr = dummy_deallocate_binding_handler;
 
     bind_to_node_ptr = dummy_bind_to_node;
+    bind_to_core_ptr = dummy_bind_to_core;
     restore_affinity_ptr = dummy_restore_affinity;
+    get_current_numa_node_ptr = dummy_get_current_numa_node;
 }
 
 void initialize() {
@@ -414,12 +430,23 @@ void bind_thread_to_node(binding_handler* handler_ptr, int slot_num , int numa_i
     bind_to_node_ptr(handler_ptr, slot_num, numa_id);
 }
 
+void bind_thread_to_core(binding_handler* handler_ptr, int slot_num, int numa_id, int policy) {
+    __TBB_ASSERT(slot_num >= 0, "Negative thread index");
+    __TBB_ASSERT(bind_to_core_ptr, "tbbbind loading was not performed");
+    bind_to_core_ptr(handler_ptr, slot_num, numa_id, policy);
+}
+
 void restore_affinity_mask(binding_handler* handler_ptr, int slot_num) {
     __TBB_ASSERT(slot_num >= 0, "Negative thread index");
     __TBB_ASSERT(restore_affinity_ptr, "tbbbind loading was not performed");
     restore_affinity_ptr(handler_ptr, slot_num);
 }
 
+int current_numa_node() {
+    __TBB_ASSERT(get_current_numa_node_ptr, "tbbbind loading was not performed");
+    return get_current_numa_node_ptr();
+}
+
 unsigned __TBB_EXPORTED_FUNC numa_node_count() {
     numa_topology::initialize();
     return numa_topology::numa_nodes_count;
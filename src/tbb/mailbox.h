@@ -145,12 +145,18 @@ public:
     //! Push task_proxy onto the mailbox queue of another thread.
     /** Implementation is wait-free. */
     void push( task_proxy* t ) {
-        __TBB_ASSERT(t, NULL);
-        t->next_in_mailbox = NULL;
-        atomic_proxy_ptr* const link = my_last.exchange(&t->next_in_mailbox);
+        push(t, t);
+    }
+
+    //! Push the chain of task_proxy objects linked through next_in_mailbox at once.
+    /** Implementation is wait-free. */
+    void push( task_proxy* first, task_proxy* last ) {
+        __TBB_ASSERT(first && last, NULL);
+        last->next_in_mailbox = NULL;
+        atomic_proxy_ptr* const link = my_last.exchange(&last->next_in_mailbox);
         // No release fence required for the next store, because there are no memory operations
         // between the previous fully fenced atomic operation and the store.
-        link->store(t, std::memory_order_relaxed);
+        link->store(first, std::memory_order_relaxed);
     }
 
     //! Return true if mailbox is empty
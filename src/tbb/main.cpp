@@ -47,9 +47,9 @@ market* market::theMarket;
 market::global_market_mutex_type market::theMarketMutex;
 
 //------------------------------------------------------------------------
-// context propagation data
-context_state_propagation_mutex_type the_context_state_propagation_mutex;
-std::atomic<uintptr_t> the_context_state_propagation_epoch{};
+// context cancellation data
+external_threads_list_mutex_type the_external_threads_list_mutex;
+std::atomic<uintptr_t> the_context_cancellation_epoch{};
 
 //------------------------------------------------------------------------
 // One time initialization data
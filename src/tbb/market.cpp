@@ -29,7 +29,7 @@ namespace tbb {
 namespace detail {
 namespace r1 {
 
-/** This method must be invoked under my_arenas_list_mutex. **/
+/** This method must be invoked under the locks of all the arena lists. **/
 arena* market::select_next_arena( arena* hint ) {
     unsigned next_arena_priority_level = num_priority_levels;
     if ( hint )
@@ -42,19 +42,35 @@ arena* market::select_next_arena( arena* hint ) {
     return hint;
 }
 
+/** This method must be invoked under the lock of the arena priority level. **/
 void market::insert_arena_into_list ( arena& a ) {
     __TBB_ASSERT( a.my_priority_level < num_priority_levels, nullptr );
     my_arenas[a.my_priority_level].push_front( a );
-    __TBB_ASSERT( !my_next_arena || my_next_arena->my_priority_level < num_priority_levels, nullptr );
-    my_next_arena = select_next_arena( my_next_arena );
 }
 
+/** This method must be invoked under the lock of the arena priority level. **/
 void market::remove_arena_from_list ( arena& a ) {
     __TBB_ASSERT( a.my_priority_level < num_priority_levels, nullptr );
     my_arenas[a.my_priority_level].remove( a );
-    if ( my_next_arena == &a )
-        my_next_arena = nullptr;
-    my_next_arena = select_next_arena( my_next_arena );
+}
+
+void market::lock_arenas_lists ( bool is_writer ) {
+    // The same order for all the threads prevents deadlocks
+    for ( unsigned level = 0; level < num_priority_levels; ++level ) {
+        if ( is_writer )
+            my_arenas_list_mutex[level].lock();
+        else
+            my_arenas_list_mutex[level].lock_shared();
+    }
+}
+
+void market::unlock_arenas_lists ( bool is_writer ) {
+    for ( unsigned level = num_priority_levels; level-- > 0; ) {
+        if ( is_writer )
+            my_arenas_list_mutex[level].unlock();
+        else
+            my_arenas_list_mutex[level].unlock_shared();
+    }
 }
 
 //------------------------------------------------------------------------
@@ -64,7 +80,6 @@ void market::remove_arena_from_list ( arena& a ) {
 market::market ( unsigned workers_soft_limit, unsigned workers_hard_limit, std::size_t stack_size )
     : my_num_workers_hard_limit(workers_hard_limit)
     , my_num_workers_soft_limit(workers_soft_limit)
-    , my_next_arena(nullptr)
     , my_ref_count(1)
     , my_stack_size(stack_size)
     , my_workers_soft_limit_to_report(workers_soft_limit)
@@ -244,7 +259,7 @@ void market::set_active_num_workers ( unsigned soft_limit ) {
 
     int delta = 0;
     {
-        arenas_list_mutex_type::scoped_lock lock( m->my_arenas_list_mutex );
+        arenas_list_lock lock( *m );
         __TBB_ASSERT(soft_limit <= m->my_num_workers_hard_limit, NULL);
 
 #if __TBB_ENQUEUE_ENFORCED_CONCURRENCY
@@ -295,22 +310,26 @@ arena* market::create_arena ( int num_slots, int num_reserved_slots, unsigned ar
     // Add public market reference for master thread/task_arena (that adds an internal reference in exchange).
     market &m = global_market( /*is_public=*/true, num_slots-num_reserved_slots, stack_size );
     arena& a = arena::allocate_arena( m, num_slots, num_reserved_slots, arena_priority_level );
-    // Add newly created arena into the existing market's list.
-    arenas_list_mutex_type::scoped_lock lock(m.my_arenas_list_mutex);
+    // Add newly created arena into the existing market's list. The lists of other priority levels
+    // are not affected, so the workers allotment does not need to be updated.
+    arenas_list_mutex_type::scoped_lock lock(m.my_arenas_list_mutex[arena_priority_level]);
     m.insert_arena_into_list(a);
     return &a;
 }
 
-/** This method must be invoked under my_arenas_list_mutex. **/
+/** This method must be invoked under the lock of the arena priority level. **/
 void market::detach_arena ( arena& a ) {
     __TBB_ASSERT( theMarket == this, "Global market instance was destroyed prematurely?" );
     __TBB_ASSERT( !a.my_slots[0].is_occupied(), NULL );
+#if __TBB_ENQUEUE_ENFORCED_CONCURRENCY
     if (a.my_global_concurrency_mode.load(std::memory_order_relaxed))
         disable_mandatory_concurrency_impl(&a);
+#endif
 
     remove_arena_from_list(a);
-    if ( a.my_aba_epoch == my_arenas_aba_epoch )
-        ++my_arenas_aba_epoch;
+    // Other priority levels can detach their arenas concurrently
+    uintptr_t aba_epoch = a.my_aba_epoch;
+    my_arenas_aba_epoch.compare_exchange_strong(aba_epoch, aba_epoch + 1);
 }
 
 void market::try_destroy_arena ( arena* a, uintptr_t aba_epoch, unsigned priority_level ) {
@@ -319,7 +338,8 @@ void market::try_destroy_arena ( arena* a, uintptr_t aba_epoch, unsigned priorit
     // we hold reference to the market, so it cannot be destroyed at any moment here
     __TBB_ASSERT( this == theMarket, NULL );
     __TBB_ASSERT( my_ref_count!=0, NULL );
-    my_arenas_list_mutex.lock();
+    arenas_list_mutex_type& mutex = my_arenas_list_mutex[priority_level];
+    mutex.lock();
     assert_market_valid();
         arena_list_type::iterator it = my_arenas[priority_level].begin();
         for ( ; it != my_arenas[priority_level].end(); ++it ) {
@@ -334,20 +354,20 @@ void market::try_destroy_arena ( arena* a, uintptr_t aba_epoch, unsigned priorit
                         );
                         // Arena is abandoned. Destroy it.
                         detach_arena( *a );
-                        my_arenas_list_mutex.unlock();
+                        mutex.unlock();
                         locked = false;
                         a->free_arena();
                     }
                 }
                 if (locked)
-                    my_arenas_list_mutex.unlock();
+                    mutex.unlock();
                 return;
             }
         }
-    my_arenas_list_mutex.unlock();
+    mutex.unlock();
 }
 
-/** This method must be invoked under my_arenas_list_mutex. **/
+/** This method must be invoked under the locks of all the arena lists. **/
 arena* market::arena_in_need ( arena_list_type* arenas, arena* hint ) {
     // TODO: make sure arena with higher priority returned only if there are available slots in it.
     hint = select_next_arena( hint );
@@ -376,11 +396,12 @@ arena* market::arena_in_need(arena* prev) {
     atomic_fence(std::memory_order_acquire);
     if (my_total_demand <= 0)
         return nullptr;
-    arenas_list_mutex_type::scoped_lock lock(my_arenas_list_mutex, /*is_writer=*/false);
+    arenas_list_lock lock(*this, /*is_writer=*/false);
     // TODO: introduce three state response: alive, not_alive, no_market_arenas
     if ( is_arena_alive(prev) )
         return arena_in_need(my_arenas, prev);
-    return arena_in_need(my_arenas, my_next_arena);
+    // Start from the first arena of the highest priority level
+    return arena_in_need(my_arenas, nullptr);
 }
 
 int market::update_allotment ( arena_list_type* arenas, int workers_demand, int max_workers ) {
@@ -430,7 +451,7 @@ int market::update_allotment ( arena_list_type* arenas, int workers_demand, int
     return assigned;
 }
 
-/** This method must be invoked under my_arenas_list_mutex. **/
+/** This method must be invoked under the lock of the arena list. **/
 bool market::is_arena_in_list( arena_list_type &arenas, arena *a ) {
     __TBB_ASSERT( a, "Expected non-null pointer to arena." );
     for ( arena_list_type::iterator it = arenas.begin(); it != arenas.end(); ++it )
@@ -439,7 +460,7 @@ bool market::is_arena_in_list( arena_list_type &arenas, arena *a ) {
     return false;
 }
 
-/** This method must be invoked under my_arenas_list_mutex. **/
+/** This method must be invoked under the locks of all the arena lists. **/
 bool market::is_arena_alive(arena* a) {
     if ( !a )
         return false;
@@ -465,7 +486,7 @@ void market::enable_mandatory_concurrency_impl ( arena *a ) {
 void market::enable_mandatory_concurrency ( arena *a ) {
     int delta = 0;
     {
-        arenas_list_mutex_type::scoped_lock lock(my_arenas_list_mutex);
+        arenas_list_lock lock(*this);
         if (my_num_workers_soft_limit.load(std::memory_order_relaxed) != 0 ||
             a->my_global_concurrency_mode.load(std::memory_order_relaxed))
             return;
@@ -489,7 +510,7 @@ void market::disable_mandatory_concurrency_impl(arena* a) {
 void market::mandatory_concurrency_disable ( arena *a ) {
     int delta = 0;
     {
-        arenas_list_mutex_type::scoped_lock lock(my_arenas_list_mutex);
+        arenas_list_lock lock(*this);
         if (!a->my_global_concurrency_mode.load(std::memory_order_relaxed))
             return;
         // There is a racy window in advertise_new_work between mandtory concurrency enabling and 
@@ -512,7 +533,8 @@ void market::adjust_demand ( arena& a, int delta ) {
     __TBB_ASSERT( theMarket, "market instance was destroyed prematurely?" );
     if ( !delta )
         return;
-    my_arenas_list_mutex.lock();
+    // The allotment depends on the demand of all the priority levels
+    lock_arenas_lists(/*is_writer=*/true);
     a.my_total_num_workers_requested += delta;
     int target_workers = 0;
     // Cap target_workers into interval [0, a.my_max_num_workers]
@@ -524,7 +546,7 @@ void market::adjust_demand ( arena& a, int delta ) {
     delta = target_workers - a.my_num_workers_requested;
 
     if (delta == 0) {
-        my_arenas_list_mutex.unlock();
+        unlock_arenas_lists(/*is_writer=*/true);
         return;
     }
 
@@ -557,7 +579,7 @@ void market::adjust_demand ( arena& a, int delta ) {
 
     int target_epoch = my_adjust_demand_target_epoch++;
 
-    my_arenas_list_mutex.unlock();
+    unlock_arenas_lists(/*is_writer=*/true);
 
     spin_wait_until_eq(my_adjust_demand_current_epoch, target_epoch);
     // Must be called outside of any locks
@@ -606,12 +628,12 @@ void market::acknowledge_close_connection() {
 }
 
 void market::add_external_thread(thread_data& td) {
-    context_state_propagation_mutex_type::scoped_lock lock(the_context_state_propagation_mutex);
+    external_threads_list_mutex_type::scoped_lock lock(the_external_threads_list_mutex);
     my_masters.push_front(td);
 }
 
 void market::remove_external_thread(thread_data& td) {
-    context_state_propagation_mutex_type::scoped_lock lock(the_context_state_propagation_mutex);
+    external_threads_list_mutex_type::scoped_lock lock(the_external_threads_list_mutex);
     my_masters.remove(td);
 }
 
@@ -84,8 +84,28 @@ private:
 
     //! Lightweight mutex guarding accounting operations with arenas list
     typedef spin_rw_mutex arenas_list_mutex_type;
-    // TODO: introduce fine-grained (per priority list) locking of arenas.
-    arenas_list_mutex_type my_arenas_list_mutex;
+    //! Per priority level mutexes guarding the arena lists
+    /** Insertions and deletions of arenas lock the list of the arena priority level only.
+        Operations depending on all the lists, e.g. the allotment of workers, lock the lists
+        of all the priority levels in the order of the levels (see arenas_list_lock). **/
+    padded<arenas_list_mutex_type> my_arenas_list_mutex[num_priority_levels];
+
+    //! Locks the arena lists of all the priority levels
+    class arenas_list_lock : no_copy {
+    public:
+        arenas_list_lock(market& m, bool is_writer = true) : my_market(m), my_is_writer(is_writer) {
+            my_market.lock_arenas_lists(my_is_writer);
+        }
+        ~arenas_list_lock() {
+            my_market.unlock_arenas_lists(my_is_writer);
+        }
+    private:
+        market& my_market;
+        const bool my_is_writer;
+    };
+
+    void lock_arenas_lists(bool is_writer);
+    void unlock_arenas_lists(bool is_writer);
 
     //! Pointer to the RML server object that services this TBB instance.
     rml::tbb_server* my_server;
@@ -123,18 +143,15 @@ private:
 
 #if __TBB_ENQUEUE_ENFORCED_CONCURRENCY
     //! How many times mandatory concurrency was requested from the market
-    int my_mandatory_num_requested;
+    /** Can be decreased by the destruction of arenas that lock their priority levels only. **/
+    std::atomic<int> my_mandatory_num_requested;
 #endif
 
     //! Per priority list of registered arenas
     arena_list_type my_arenas[num_priority_levels];
 
-    //! The first arena to be checked when idle worker seeks for an arena to enter
-    /** The check happens in round-robin fashion. **/
-    arena *my_next_arena;
-
     //! ABA prevention marker to assign to newly created arenas
-    uintptr_t my_arenas_aba_epoch;
+    std::atomic<uintptr_t> my_arenas_aba_epoch;
 
     //! Reference count controlling market object lifetime
     std::atomic<unsigned> my_ref_count;
@@ -270,14 +287,6 @@ public:
     static unsigned is_lifetime_control_present();
 #endif
 
-    //! Finds all contexts affected by the state change and propagates the new state to them.
-    /** The propagation is relayed to the market because tasks created by one
-        master thread can be passed to and executed by other masters. This means
-        that context trees can span several arenas at once and thus state change
-        propagation cannot be generally localized to one arena only. **/
-    template <typename T>
-    bool propagate_task_group_state (std::atomic<T> d1::task_group_context::*mptr_state, d1::task_group_context& src, T new_state );
-
     //! List of registered master threads
     thread_data_list_type my_masters;
 
@@ -224,7 +224,12 @@ class binding_handler;
 binding_handler* construct_binding_handler(int slot_num);
 void destroy_binding_handler(binding_handler* handler_ptr);
 void bind_thread_to_node(binding_handler* handler_ptr, int slot_num , int numa_id);
+//! Pins the thread to the core chosen for the slot by the policy among the cores of the NUMA node
+/** The numa_id is -1 to choose among all the cores of the process. **/
+void bind_thread_to_core(binding_handler* handler_ptr, int slot_num, int numa_id, int policy);
 void restore_affinity_mask(binding_handler* handler_ptr, int slot_num);
+//! Returns the NUMA node index the calling thread runs on, or -1 if it is unknown.
+int current_numa_node();
 
 namespace numa_topology {
     bool is_initialized();
@@ -99,6 +99,7 @@ void observer_list::insert( observer_proxy* p ) {
         my_head = p;
     }
     my_tail = p;
+    my_epoch.store(my_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 }
 
 void observer_list::remove(observer_proxy* p) {
@@ -119,6 +120,8 @@ void observer_list::remove(observer_proxy* p) {
         p->my_prev->my_next = p->my_next;
     }
     __TBB_ASSERT((my_head && my_tail) || (!my_head && !my_tail), nullptr);
+    // Removal is always done under the writer lock, so the plain increment is enough.
+    my_epoch.store(my_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 }
 
 void observer_list::remove_ref(observer_proxy* p) {
@@ -145,118 +148,140 @@ void observer_list::remove_ref(observer_proxy* p) {
     }
 }
 
-void observer_list::do_notify_entry_observers(observer_proxy*& last, bool worker) {
-    // Pointer p marches though the list from last (exclusively) to the end.
-    observer_proxy* p = last, * prev = p;
+//! Calls the observers pinned by the batch and releases them even if a callback throws
+class observer_list::observer_batch : no_copy {
+    d1::task_scheduler_observer* my_observers[max_batch_size];
+    std::size_t my_size{0};
+    std::size_t my_notified{0};
+public:
+    bool is_full() const { return my_size == max_batch_size; }
+
+    //! Must be called under the list lock, so the observer cannot be destroyed meanwhile.
+    void add(d1::task_scheduler_observer* tso) {
+        __TBB_ASSERT(!is_full(), nullptr);
+        ++tso->my_busy_count;
+        my_observers[my_size++] = tso;
+    }
+
+    // Do not hold any locks on the list while calling user's code.
+    // Do not intercept any exceptions that may escape the callback so that
+    // they are either handled by the TBB scheduler or passed to the debugger.
+    void notify_entry(bool worker) {
+        for (; my_notified < my_size; ++my_notified) {
+            my_observers[my_notified]->on_scheduler_entry(worker);
+            release(*my_observers[my_notified]);
+        }
+    }
+
+    void notify_exit(bool worker) {
+        for (; my_notified < my_size; ++my_notified) {
+            my_observers[my_notified]->on_scheduler_exit(worker);
+            release(*my_observers[my_notified]);
+        }
+    }
+
+    static void release(d1::task_scheduler_observer& tso) {
+        intptr_t bc = --tso.my_busy_count;
+        __TBB_ASSERT_EX(bc >= 0, "my_busy_count underflowed");
+    }
+
+    ~observer_batch() {
+        // Unblock observe(false) for the observers skipped because of an exception
+        for (std::size_t i = my_notified; i < my_size; ++i) {
+            release(*my_observers[i]);
+        }
+    }
+};
+
+void observer_list::do_notify_entry_observers(observer_proxy*& last, std::uintptr_t& last_epoch, bool worker) {
+    // The observers after last (exclusively) to the end of the list are notified in batches.
+    // Only the last proxy of the batch is referenced to continue the walk from it;
+    // the observers themselves are kept alive by their busy counts.
     for (;;) {
-        d1::task_scheduler_observer* tso = nullptr;
-        // Hold lock on list only long enough to advance to the next proxy in the list.
+        observer_batch batch;
+        observer_proxy* prev = nullptr;
+        bool is_end = false;
         {
             scoped_lock lock(mutex(), /*is_writer=*/false);
-            do {
-                if (p) {
-                    // We were already processing the list.
-                    if (observer_proxy* q = p->my_next) {
-                        if (p == prev) {
-                            remove_ref_fast(prev); // sets prev to NULL if successful
-                        }
-                        p = q;
-                    } else {
-                        // Reached the end of the list.
-                        if (p == prev) {
-                            // Keep the reference as we store the 'last' pointer in scheduler
-                            __TBB_ASSERT(int(p->my_ref_count.load(std::memory_order_relaxed)) >= 1 + (p->my_observer ? 1 : 0), nullptr);
-                        } else {
-                            // The last few proxies were empty
-                            __TBB_ASSERT(int(p->my_ref_count.load(std::memory_order_relaxed)), nullptr);
-                            ++p->my_ref_count;
-                            if (prev) {
-                                lock.release();
-                                remove_ref(prev);
-                            }
-                        }
-                        last = p;
-                        return;
-                    }
-                } else {
-                    // Starting pass through the list
-                    p = my_head;
-                    if (!p) {
-                        return;
-                    }
+            // The list cannot change while the lock is held.
+            last_epoch = my_epoch.load(std::memory_order_relaxed);
+            observer_proxy* p = last ? last->my_next : my_head;
+            observer_proxy* batch_last = last;
+            for (; p && !batch.is_full(); p = p->my_next) {
+                if (d1::task_scheduler_observer* tso = p->my_observer) {
+                    batch.add(tso);
+                }
+                batch_last = p;
+            }
+            is_end = p == nullptr;
+            if (batch_last != last) {
+                __TBB_ASSERT(int(batch_last->my_ref_count.load(std::memory_order_relaxed)), nullptr);
+                ++batch_last->my_ref_count;
+                prev = last;
+                if (prev) {
+                    remove_ref_fast(prev); // sets prev to NULL if successful
                 }
-                tso = p->my_observer;
-            } while (!tso);
-            ++p->my_ref_count;
-            ++tso->my_busy_count;
+                last = batch_last;
+            }
         }
-        __TBB_ASSERT(!prev || p != prev, nullptr);
-        // Release the proxy pinned before p
+        // Release the proxy pinned before the batch
         if (prev) {
             remove_ref(prev);
         }
-        // Do not hold any locks on the list while calling user's code.
-        // Do not intercept any exceptions that may escape the callback so that
-        // they are either handled by the TBB scheduler or passed to the debugger.
-        tso->on_scheduler_entry(worker);
-        __TBB_ASSERT(p->my_ref_count.load(std::memory_order_relaxed), nullptr);
-        intptr_t bc = --tso->my_busy_count;
-        __TBB_ASSERT_EX(bc >= 0, "my_busy_count underflowed");
-        prev = p;
+        batch.notify_entry(worker);
+        if (is_end) {
+            return;
+        }
     }
 }
 
 void observer_list::do_notify_exit_observers(observer_proxy* last, bool worker) {
-    // Pointer p marches though the list from the beginning to last (inclusively).
-    observer_proxy* p = nullptr, * prev = nullptr;
+    // The observers from the beginning of the list to last (inclusively) are notified in batches.
+    // The last proxy of each batch except the final one is referenced to continue the walk from it;
+    // last is already referenced since the entry notification.
+    observer_proxy* p = nullptr;
     for (;;) {
-        d1::task_scheduler_observer* tso = nullptr;
-        // Hold lock on list only long enough to advance to the next proxy in the list.
+        observer_batch batch;
+        observer_proxy* prev = p != last ? p : nullptr;
+        bool is_end = false;
         {
             scoped_lock lock(mutex(), /*is_writer=*/false);
-            do {
-                if (p) {
-                    // We were already processing the list.
-                    if (p != last) {
-                        __TBB_ASSERT(p->my_next, "List items before 'last' must have valid my_next pointer");
-                        if (p == prev)
-                            remove_ref_fast(prev); // sets prev to NULL if successful
-                        p = p->my_next;
-                    } else {
-                        // remove the reference from the last item
-                        remove_ref_fast(p);
-                        if (p) {
-                            lock.release();
-                            if (p != prev && prev) {
-                                remove_ref(prev);
-                            }
-                            remove_ref(p);
-                        }
-                        return;
-                    }
-                } else {
-                    // Starting pass through the list
-                    p = my_head;
-                    __TBB_ASSERT(p, "Nonzero 'last' must guarantee that the global list is non-empty");
+            observer_proxy* q = p ? p->my_next : my_head;
+            for (;;) {
+                __TBB_ASSERT(q, "List items before 'last' must have valid my_next pointer");
+                if (d1::task_scheduler_observer* tso = q->my_observer) {
+                    batch.add(tso);
                 }
-                tso = p->my_observer;
-            } while (!tso);
-            // The item is already refcounted
-            if (p != last) // the last is already referenced since entry notification
+                if (q == last) {
+                    is_end = true;
+                    break;
+                }
+                if (batch.is_full()) {
+                    break;
+                }
+                q = q->my_next;
+            }
+            p = q;
+            if (!is_end) {
                 ++p->my_ref_count;
-            ++tso->my_busy_count;
+            } else {
+                // remove the reference from the last item
+                remove_ref_fast(p); // sets p to NULL if successful
+            }
+            if (prev) {
+                remove_ref_fast(prev); // sets prev to NULL if successful
+            }
         }
-        __TBB_ASSERT(!prev || p != prev, nullptr);
-        if (prev)
+        if (prev) {
             remove_ref(prev);
-        // Do not hold any locks on the list while calling user's code.
-        // Do not intercept any exceptions that may escape the callback so that
-        // they are either handled by the TBB scheduler or passed to the debugger.
-        tso->on_scheduler_exit(worker);
-        __TBB_ASSERT(p->my_ref_count || p == last, nullptr);
-        intptr_t bc = --tso->my_busy_count;
-        __TBB_ASSERT_EX(bc >= 0, "my_busy_count underflowed");
-        prev = p;
+        }
+        if (is_end && p) {
+            remove_ref(p);
+        }
+        batch.notify_exit(worker);
+        if (is_end) {
+            return;
+        }
     }
 }
 
@@ -288,7 +313,7 @@ void __TBB_EXPORTED_FUNC observe(d1::task_scheduler_observer &tso, bool enable)
             p->my_list->insert(p);
             // Notify newly activated observer and other pending ones if it belongs to current arena
             if (td && td->my_arena && &td->my_arena->my_observers == p->my_list) {
-                p->my_list->notify_entry_observers(td->my_last_observer, td->my_is_worker);
+                p->my_list->notify_entry_observers(td->my_last_observer, td->my_last_observer_epoch, td->my_is_worker);
             }
         }
     } else {
@@ -23,6 +23,10 @@
 #include "oneapi/tbb/task_scheduler_observer.h"
 #include "oneapi/tbb/spin_rw_mutex.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 namespace tbb {
 namespace detail {
 namespace r1 {
@@ -46,12 +50,24 @@ class observer_list {
     //! Back-pointer to the arena this list belongs to.
     arena* my_arena;
 
+    //! Incremented under the writer lock whenever a proxy is inserted or removed.
+    /** A thread that remembers the epoch of its last entry notification can skip
+        the list if the epoch has not changed since then. Zero is never the epoch
+        of a non-empty list. **/
+    std::atomic<std::uintptr_t> my_epoch{0};
+
+    //! The number of observers notified under one lock acquisition
+    static constexpr std::size_t max_batch_size = 8;
+
+    //! Observers pinned under the lock to be notified after its release
+    class observer_batch;
+
     //! Decrement refcount of the proxy p if there are other outstanding references.
     /** In case of success sets p to NULL. Must be invoked from under the list lock. **/
     inline static void remove_ref_fast( observer_proxy*& p );
 
     //! Implements notify_entry_observers functionality.
-    void do_notify_entry_observers( observer_proxy*& last, bool worker );
+    void do_notify_entry_observers( observer_proxy*& last, std::uintptr_t& last_epoch, bool worker );
 
     //! Implements notify_exit_observers functionality.
     void do_notify_exit_observers( observer_proxy* last, bool worker );
@@ -83,8 +99,9 @@ public:
 
     //! Call entry notifications on observers added after last was notified.
     /** Updates last to become the last notified observer proxy (in the global list)
-        or leaves it to be nullptr. The proxy has its refcount incremented. **/
-    inline void notify_entry_observers( observer_proxy*& last, bool worker );
+        or leaves it to be nullptr. The proxy has its refcount incremented.
+        Returns immediately if the list has not changed since last_epoch. **/
+    inline void notify_entry_observers( observer_proxy*& last, std::uintptr_t& last_epoch, bool worker );
 
     //! Call exit notifications on last and observers added before it.
     inline void notify_exit_observers( observer_proxy*& last, bool worker );
@@ -131,10 +148,11 @@ void observer_list::remove_ref_fast( observer_proxy*& p ) {
     }
 }
 
-void observer_list::notify_entry_observers(observer_proxy*& last, bool worker) {
-    if (last == my_tail)
+void observer_list::notify_entry_observers(observer_proxy*& last, std::uintptr_t& last_epoch, bool worker) {
+    // Acquire synchronizes with the list update made before the epoch increment.
+    if (last_epoch == my_epoch.load(std::memory_order_acquire))
         return;
-    do_notify_entry_observers(last, worker);
+    do_notify_entry_observers(last, last_epoch, worker);
 }
 
 void observer_list::notify_exit_observers( observer_proxy*& last, bool worker ) {
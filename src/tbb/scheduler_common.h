@@ -233,24 +233,32 @@ inline void prolonged_pause() {
     prolonged_pause_impl();
 }
 
+//! The wait policy selected with global_control::wait_policy
+std::size_t wait_policy();
+
+//! The allotment policy selected with global_control::allotment_policy
+std::size_t allotment_policy();
+
 class stealing_loop_backoff {
     const int my_pause_threshold;
-    const int my_yield_threshold;
+    int my_yield_threshold;
     int my_pause_count;
     int my_yield_count;
 public:
-    // my_yield_threshold = 100 is an experimental value. Ideally, once we start calling __TBB_Yield(),
+    // default_yield_threshold = 100 is an experimental value. Ideally, once we start calling __TBB_Yield(),
     // the time spent spinning before calling is_out_of_work() should be approximately
     // the time it takes for a thread to be woken up. Doing so would guarantee that we do
     // no worse than 2x the optimal spin time. Or perhaps a time-slice quantum is the right amount.
-    stealing_loop_backoff(int num_workers)
-        : my_pause_threshold{ 2 * (num_workers + 1) }
 #if __APPLE__
-        // threshold value tuned separately for macOS due to high cost of sched_yield there
-        , my_yield_threshold{10}
+    // threshold value tuned separately for macOS due to high cost of sched_yield there
+    static constexpr int default_yield_threshold = 10;
 #else
-        , my_yield_threshold{100}
+    static constexpr int default_yield_threshold = 100;
 #endif
+
+    stealing_loop_backoff(int num_workers)
+        : my_pause_threshold{ 2 * (num_workers + 1) }
+        , my_yield_threshold{default_yield_threshold}
         , my_pause_count{}
         , my_yield_count{}
     {}
@@ -269,27 +277,36 @@ public:
     void reset_wait() {
         my_pause_count = my_yield_count = 0;
     }
+
+    //! Changes the number of yields made before reporting that the wait is too long
+    void set_yield_threshold(int threshold) {
+        my_yield_threshold = threshold;
+    }
+
+    //! Returns true if the thread has paused since the last reset
+    bool has_paused() const {
+        return my_pause_count > 0;
+    }
+
+    //! The number of yields made since the last reset
+    int yield_count() const {
+        return my_yield_count;
+    }
 };
 
 //------------------------------------------------------------------------
 // Exception support
 //------------------------------------------------------------------------
-//! Task group state change propagation global epoch
-/** Together with generic_scheduler::my_context_state_propagation_epoch forms
-    cross-thread signaling mechanism that allows to avoid locking at the hot path
-    of normal execution flow.
-
-    When a descendant task group context is registered or unregistered, the global
-    and local epochs are compared. If they differ, a state change is being propagated,
-    and thus registration/deregistration routines take slower branch that may block
-    (at most one thread of the pool can be blocked at any moment). Otherwise the
-    control path is lock-free and fast. **/
-extern std::atomic<std::uintptr_t> the_context_state_propagation_epoch;
-
-//! Mutex guarding state change propagation across task groups forest.
-/** Also protects modification of related data structures. **/
-typedef scheduler_mutex_type context_state_propagation_mutex_type;
-extern context_state_propagation_mutex_type the_context_state_propagation_mutex;
+//! Global epoch of task group cancellations
+/** Incremented each time a context that may have children is cancelled. A context
+    caches the epoch at which it has checked that none of its ancestors is cancelled,
+    so the ancestors are checked again only after some cancellation has happened.
+    Thus a cancellation does not need to find and update all the descendant contexts. **/
+extern std::atomic<std::uintptr_t> the_context_cancellation_epoch;
+
+//! Mutex protecting the list of the external threads registered in the market.
+typedef scheduler_mutex_type external_threads_list_mutex_type;
+extern external_threads_list_mutex_type the_external_threads_list_mutex;
 
 class tbb_exception_ptr {
     std::exception_ptr my_ptr;
@@ -482,10 +499,8 @@ struct task_group_context_impl {
     static void register_with(d1::task_group_context&, thread_data*);
     static void bind_to_impl(d1::task_group_context&, thread_data*);
     static void bind_to(d1::task_group_context&, thread_data*);
-    template <typename T>
-    static void propagate_task_group_state(d1::task_group_context&, std::atomic<T> d1::task_group_context::*, d1::task_group_context&, T);
     static bool cancel_group_execution(d1::task_group_context&);
-    static bool is_group_execution_cancelled(const d1::task_group_context&);
+    static bool is_group_execution_cancelled(d1::task_group_context&);
     static void reset(d1::task_group_context&);
     static void capture_fp_settings(d1::task_group_context&);
     static void copy_fp_settings(d1::task_group_context& ctx, const d1::task_group_context& src);
@@ -0,0 +1,196 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "oneapi/tbb/detail/_config.h"
+#include "oneapi/tbb/detail/_utils.h"
+#include "oneapi/tbb/cache_aligned_allocator.h"
+#include "oneapi/tbb/spin_mutex.h"
+#include "oneapi/tbb/profiling.h"
+
+#include "scheduler_trace.h"
+
+#if __TBB_SCHEDULER_TRACE
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <vector>
+#endif
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+#if __TBB_SCHEDULER_TRACE
+std::uint64_t trace_buffer::time_stamp() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+//! Keeps the trace buffers of all the threads that have been registered in the scheduler
+/** The buffers are never freed, so the events of the finished threads remain available
+    until their buffers are reused by new threads. **/
+class trace_registry {
+    spin_mutex my_mutex;
+    trace_buffer* my_buffers{nullptr};
+    unsigned my_num_threads{0};
+    //! The events recorded before this time stamp are not exported
+    std::atomic<std::uint64_t> my_start_time{0};
+
+    static const char* event_name(trace_event_type type) {
+        switch (type) {
+        case trace_event_type::spawn: return "spawn";
+        case trace_event_type::execute_begin:
+        case trace_event_type::execute_end: return "task";
+        case trace_event_type::steal: return "steal";
+        case trace_event_type::mailbox_take: return "mailbox";
+        case trace_event_type::sleep_begin:
+        case trace_event_type::sleep_end: return "sleep";
+        case trace_event_type::arena_join:
+        case trace_event_type::arena_leave: return "arena";
+        }
+        return "unknown";
+    }
+
+    //! Returns the Chrome trace event phase and the name of the event argument
+    static char event_phase(trace_event_type type, const char*& arg_name) {
+        arg_name = nullptr;
+        switch (type) {
+        case trace_event_type::spawn: arg_name = "tasks"; return 'i';
+        case trace_event_type::steal: arg_name = "victim"; return 'i';
+        case trace_event_type::mailbox_take: return 'i';
+        case trace_event_type::arena_join: arg_name = "slot"; return 'B';
+        case trace_event_type::arena_leave: arg_name = "slot"; return 'E';
+        case trace_event_type::execute_begin:
+        case trace_event_type::sleep_begin: return 'B';
+        default: return 'E';
+        }
+    }
+
+    //! Copies the events that have not been overwritten while copying
+    std::uint64_t snapshot(trace_buffer& b, std::vector<trace_event>& events) {
+        constexpr std::uint64_t capacity = trace_buffer::capacity;
+        std::uint64_t tail = b.my_tail.load(std::memory_order_acquire);
+        std::uint64_t head = tail > capacity ? tail - capacity : 0;
+        events.clear();
+        for (std::uint64_t i = head; i < tail; ++i) {
+            events.push_back(b.my_events[i & (capacity - 1)]);
+        }
+        // The owner thread can overwrite the oldest events meanwhile
+        std::uint64_t new_tail = b.my_tail.load(std::memory_order_acquire);
+        std::uint64_t valid_head = new_tail > capacity ? new_tail - capacity : 0;
+        return valid_head > head ? valid_head - head : 0;
+    }
+
+public:
+    trace_buffer* acquire(bool is_worker) {
+        spin_mutex::scoped_lock lock(my_mutex);
+        trace_buffer* b = my_buffers;
+        while (b != nullptr && !b->my_is_retired) {
+            b = b->my_next;
+        }
+        if (b == nullptr) {
+            b = new (cache_aligned_allocate(sizeof(trace_buffer))) trace_buffer{};
+            b->my_next = my_buffers;
+            my_buffers = b;
+        }
+        // The events of the previous owner are dropped
+        b->my_tail.store(0, std::memory_order_relaxed);
+        b->my_thread_id = my_num_threads++;
+        b->my_is_worker = is_worker;
+        b->my_is_retired = false;
+        return b;
+    }
+
+    void release(trace_buffer* b) {
+        spin_mutex::scoped_lock lock(my_mutex);
+        b->my_is_retired = true;
+    }
+
+    void clear() {
+        my_start_time.store(trace_buffer::time_stamp(), std::memory_order_relaxed);
+    }
+
+    bool write(const char* file_name) {
+        std::FILE* f = std::fopen(file_name, "w");
+        if (f == nullptr) {
+            return false;
+        }
+        std::uint64_t start_time = my_start_time.load(std::memory_order_relaxed);
+        std::vector<trace_event> events;
+        events.reserve(trace_buffer::capacity);
+        bool is_first = true;
+        auto separator = [&is_first] { const char* s = is_first ? "\n" : ",\n"; is_first = false; return s; };
+
+        std::fprintf(f, "{\"traceEvents\":[");
+        spin_mutex::scoped_lock lock(my_mutex);
+        for (trace_buffer* b = my_buffers; b != nullptr; b = b->my_next) {
+            unsigned tid = b->my_thread_id;
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                separator(), tid, b->my_is_worker ? "worker" : "external", tid);
+            for (std::size_t i = snapshot(*b, events); i < events.size(); ++i) {
+                const trace_event& e = events[i];
+                if (e.time_stamp < start_time) {
+                    continue;
+                }
+                const char* arg_name = nullptr;
+                char phase = event_phase(e.type, arg_name);
+                std::fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"tbb\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u",
+                    separator(), event_name(e.type), phase, (unsigned long long)(e.time_stamp / 1000),
+                    unsigned(e.time_stamp % 1000), tid);
+                if (phase == 'i') {
+                    std::fprintf(f, ",\"s\":\"t\"");
+                }
+                if (arg_name != nullptr) {
+                    std::fprintf(f, ",\"args\":{\"%s\":%u}", arg_name, e.arg);
+                }
+                std::fprintf(f, "}");
+            }
+        }
+        std::fprintf(f, "\n],\"displayTimeUnit\":\"ns\"}\n");
+        return std::fclose(f) == 0;
+    }
+};
+
+static trace_registry the_trace_registry;
+
+trace_buffer* acquire_trace_buffer(bool is_worker) {
+    return the_trace_registry.acquire(is_worker);
+}
+
+void release_trace_buffer(trace_buffer* buffer) {
+    the_trace_registry.release(buffer);
+}
+#endif /* __TBB_SCHEDULER_TRACE */
+
+bool __TBB_EXPORTED_FUNC write_scheduler_trace(const char* file_name) {
+#if __TBB_SCHEDULER_TRACE
+    __TBB_ASSERT(file_name, "The file name must be specified");
+    return the_trace_registry.write(file_name);
+#else
+    suppress_unused_warning(file_name);
+    return false;
+#endif /* __TBB_SCHEDULER_TRACE */
+}
+
+void __TBB_EXPORTED_FUNC clear_scheduler_trace() {
+#if __TBB_SCHEDULER_TRACE
+    the_trace_registry.clear();
+#endif /* __TBB_SCHEDULER_TRACE */
+}
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
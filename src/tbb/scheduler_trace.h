@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_scheduler_trace_H
+#define _TBB_scheduler_trace_H
+
+#include "oneapi/tbb/detail/_config.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef __TBB_SCHEDULER_TRACE
+#define __TBB_SCHEDULER_TRACE 0
+#endif
+
+#if __TBB_SCHEDULER_TRACE
+    #define RECORD_TRACE_EVENT(td, type, arg) ((td).my_trace_buffer->record(trace_event_type::type, std::uint32_t(arg)))
+#else
+    #define RECORD_TRACE_EVENT(td, type, arg) ((void)0)
+#endif
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+#if __TBB_SCHEDULER_TRACE
+enum class trace_event_type : std::uint32_t {
+    //! Tasks are spawned; the argument is the number of tasks
+    spawn,
+    //! The task execution begins
+    execute_begin,
+    //! The task execution ends
+    execute_end,
+    //! A task is stolen; the argument is the victim slot index
+    steal,
+    //! A task is taken from the affinity mailbox
+    mailbox_take,
+    //! The thread goes to sleep waiting for work
+    sleep_begin,
+    //! The thread wakes up
+    sleep_end,
+    //! The thread joins an arena; the argument is the occupied slot index
+    arena_join,
+    //! The thread leaves the arena; the argument is the released slot index
+    arena_leave
+};
+
+struct trace_event {
+    std::uint64_t time_stamp;
+    trace_event_type type;
+    std::uint32_t arg;
+};
+
+//! Ring buffer of the scheduler events recorded by a single thread
+/** Only the owner thread records the events, so no read-modify-write operations are needed.
+    When the buffer is full, the oldest events are overwritten. **/
+class trace_buffer {
+public:
+    static constexpr std::size_t capacity = std::size_t(1) << 15;
+
+    void record(trace_event_type type, std::uint32_t arg) {
+        std::uint64_t tail = my_tail.load(std::memory_order_relaxed);
+        trace_event& e = my_events[tail & (capacity - 1)];
+        e.time_stamp = time_stamp();
+        e.type = type;
+        e.arg = arg;
+        my_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    static std::uint64_t time_stamp();
+
+private:
+    friend class trace_registry;
+
+    //! The number of the events recorded since the buffer has been acquired
+    std::atomic<std::uint64_t> my_tail{0};
+    //! The thread index in the exported trace
+    unsigned my_thread_id{0};
+    bool my_is_worker{false};
+    //! Set when the owner thread has finished, so the buffer can be reused by another thread
+    bool my_is_retired{false};
+    trace_buffer* my_next{nullptr};
+    trace_event my_events[capacity];
+};
+
+//! Provides the trace buffer for the thread being registered in the scheduler
+trace_buffer* acquire_trace_buffer(bool is_worker);
+//! Keeps the recorded events of the finished thread until the buffer is reused
+void release_trace_buffer(trace_buffer* buffer);
+#endif /* __TBB_SCHEDULER_TRACE */
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_scheduler_trace_H */
@@ -23,6 +23,14 @@
 
 #include <cstddef>
 
+#if __TBB_SMALL_OBJECT_SLABS
+#if _WIN32 || _WIN64
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif /* __TBB_SMALL_OBJECT_SLABS */
+
 namespace tbb {
 namespace detail {
 namespace r1 {
@@ -30,6 +38,61 @@ namespace r1 {
 small_object_pool_impl::small_object* const small_object_pool_impl::dead_public_list =
                 reinterpret_cast<small_object_pool_impl::small_object*>(1);
 
+#if __TBB_SMALL_OBJECT_SLABS
+//! Maps memory aligned to its size and asks the OS to back it with huge pages
+static void* map_slab(std::size_t size) {
+#if _WIN32 || _WIN64
+    // Large pages require a special privilege, so regular pages are used
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    // Over-allocate to be able to trim the mapping to the aligned part
+    void* ptr = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+    std::uintptr_t start = std::uintptr_t(ptr);
+    std::uintptr_t aligned_start = (start + size - 1) & ~(size - 1);
+    if (aligned_start != start) {
+        munmap(ptr, aligned_start - start);
+    }
+    if (aligned_start + size != start + 2 * size) {
+        munmap((void*)(aligned_start + size), start + size - aligned_start);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise((void*)aligned_start, size, MADV_HUGEPAGE);
+#endif
+    return (void*)aligned_start;
+#endif
+}
+
+static void unmap_slab(void* ptr, std::size_t size) {
+#if _WIN32 || _WIN64
+    suppress_unused_warning(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+small_object_pool_impl::small_object* small_object_pool_impl::allocate_from_slab() {
+    if (m_slab_cursor == m_slab_end) {
+        void* slab = map_slab(slab_size);
+        if (!slab) {
+            throw_exception(exception_id::bad_alloc);
+        }
+        // The first object of a slab links it into the list of slabs
+        m_slabs = new (slab) small_object{m_slabs};
+        m_slab_cursor = static_cast<char*>(slab) + small_object_size;
+        m_slab_end = static_cast<char*>(slab) + slab_size;
+    }
+    // The memory is first touched by the owner of the pool, so the OS places it on the NUMA node
+    // of the thread.
+    small_object* obj = new (m_slab_cursor) small_object{nullptr};
+    m_slab_cursor += small_object_size;
+    return obj;
+}
+#endif /* __TBB_SMALL_OBJECT_SLABS */
+
 void* __TBB_EXPORTED_FUNC allocate(d1::small_object_pool*& allocator, std::size_t number_of_bytes, const d1::execution_data& ed) {
     auto& tls = static_cast<const execution_data_ext&>(ed).task_disp->get_thread_data();
     auto pool = tls.my_small_object_pool;
@@ -57,7 +120,11 @@ void* small_object_pool_impl::allocate_impl(d1::small_object_pool*& allocator, s
             __TBB_ASSERT( obj, "another thread emptied the my_public_list" );
             m_private_list = obj->next;
         } else {
+#if __TBB_SMALL_OBJECT_SLABS
+            obj = allocate_from_slab();
+#else
             obj = new (cache_aligned_allocate(small_object_size)) small_object{nullptr};
+#endif
             ++m_private_counter;
         }
     } else {
@@ -92,30 +159,58 @@ void small_object_pool_impl::deallocate_impl(void* ptr, std::size_t number_of_by
             obj->next = m_private_list;
             m_private_list = obj;
         } else {
-            auto old_public_list = m_public_list.load(std::memory_order_relaxed);
-
-            for (;;) {
-                if (old_public_list == dead_public_list) {
-                    obj->~small_object();
-                    cache_aligned_deallocate(obj);
-                    if (++m_public_counter == 0)
-                    {
-                        this->~small_object_pool_impl();
-                        cache_aligned_deallocate(this);
-                    }
-                    break;
-                }
-                obj->next = old_public_list;
-                if (m_public_list.compare_exchange_strong(old_public_list, obj)) {
-                    break;
-                }
-            }
+            td.my_small_object_pool->defer_remote_deallocation(this, obj);
         }
     } else {
         cache_aligned_deallocate(ptr);
     }
 }
 
+void small_object_pool_impl::defer_remote_deallocation(small_object_pool_impl* pool, small_object* obj) {
+    if (m_remote_pool != pool) {
+        flush_remote_deallocations();
+        m_remote_pool = pool;
+        m_remote_tail = obj;
+    }
+    obj->next = m_remote_head;
+    m_remote_head = obj;
+    if (++m_remote_counter == std::int64_t(remote_batch_size)) {
+        flush_remote_deallocations();
+    }
+}
+
+void small_object_pool_impl::flush_remote_deallocations() {
+    if (m_remote_head) {
+        // The pool cannot be destroyed while the collected objects are not returned
+        m_remote_pool->return_objects(m_remote_head, m_remote_tail, m_remote_counter);
+        m_remote_head = m_remote_tail = nullptr;
+        m_remote_counter = 0;
+    }
+    m_remote_pool = nullptr;
+}
+
+void small_object_pool_impl::return_objects(small_object* head, small_object* tail, std::int64_t count) {
+    __TBB_ASSERT(head && tail && tail->next == nullptr, "the list of objects should be null-terminated");
+    auto old_public_list = m_public_list.load(std::memory_order_relaxed);
+
+    for (;;) {
+        if (old_public_list == dead_public_list) {
+            // The owner has gone, so the objects are freed, and the pool is freed with the last of them
+            cleanup_list(head);
+            if ((m_public_counter += count) == 0)
+            {
+                this->~small_object_pool_impl();
+                cache_aligned_deallocate(this);
+            }
+            break;
+        }
+        tail->next = old_public_list;
+        if (m_public_list.compare_exchange_strong(old_public_list, head)) {
+            break;
+        }
+    }
+}
+
 std::int64_t small_object_pool_impl::cleanup_list(small_object* list)
 {
     std::int64_t removed_count{};
@@ -124,14 +219,30 @@ std::int64_t small_object_pool_impl::cleanup_list(small_object* list)
         small_object* current = list;
         list = list->next;
         current->~small_object();
+#if !__TBB_SMALL_OBJECT_SLABS
+        // The objects carved from the slabs are freed together with the pool
         cache_aligned_deallocate(current);
+#endif
         ++removed_count;
     }
     return removed_count;
 }
 
+small_object_pool_impl::~small_object_pool_impl() {
+    __TBB_ASSERT(m_remote_head == nullptr, "the collected objects of other pools should be returned");
+#if __TBB_SMALL_OBJECT_SLABS
+    while (m_slabs) {
+        small_object* slab = m_slabs;
+        m_slabs = slab->next;
+        unmap_slab(slab, slab_size);
+    }
+#endif
+}
+
 void small_object_pool_impl::destroy()
 {
+    // return the objects of other pools collected by this thread
+    flush_remote_deallocations();
     // clean up private list and subtract the removed count from private counter
     m_private_counter -= cleanup_list(m_private_list);
     // Grab public list and place dead mark
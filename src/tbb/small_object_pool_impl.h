@@ -31,9 +31,19 @@ namespace r1 {
 
 class thread_data;
 
+#ifndef __TBB_SMALL_OBJECT_SLABS
+#define __TBB_SMALL_OBJECT_SLABS 0
+#endif
+
 class small_object_pool_impl : public d1::small_object_pool
 {
     static constexpr std::size_t small_object_size = 256;
+    //! The number of objects of another pool collected before returning them with a single CAS
+    static constexpr std::size_t remote_batch_size = 32;
+#if __TBB_SMALL_OBJECT_SLABS
+    //! Small objects are carved from slabs of this size backed by huge pages where possible
+    static constexpr std::size_t slab_size = 2 * 1024 * 1024;
+#endif
     struct small_object {
         small_object* next;
     };
@@ -44,10 +54,31 @@ public:
     void destroy();
 private:
     static std::int64_t cleanup_list(small_object* list);
-    ~small_object_pool_impl() = default;
+    ~small_object_pool_impl();
+
+    //! Collects an object of another pool freed by the owner of this pool
+    void defer_remote_deallocation(small_object_pool_impl* pool, small_object* obj);
+    //! Returns the collected objects to their pool
+    void flush_remote_deallocations();
+    //! Puts the null-terminated list of count objects ending with tail into the public list
+    void return_objects(small_object* head, small_object* tail, std::int64_t count);
+#if __TBB_SMALL_OBJECT_SLABS
+    small_object* allocate_from_slab();
+#endif
 private:
     alignas(max_nfs_size) small_object* m_private_list;
     std::int64_t m_private_counter{};
+    //! Objects of m_remote_pool freed by the owner of this pool
+    small_object_pool_impl* m_remote_pool{};
+    small_object* m_remote_head{};
+    small_object* m_remote_tail{};
+    std::int64_t m_remote_counter{};
+#if __TBB_SMALL_OBJECT_SLABS
+    //! The slabs of the pool linked through their first bytes
+    small_object* m_slabs{};
+    char* m_slab_cursor{};
+    char* m_slab_end{};
+#endif
     alignas(max_nfs_size) std::atomic<small_object*> m_public_list;
     std::atomic<std::int64_t> m_public_counter{};
 };
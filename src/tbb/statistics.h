@@ -0,0 +1,85 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_statistics_H
+#define _TBB_statistics_H
+
+#include "oneapi/tbb/detail/_config.h"
+#include "oneapi/tbb/task_arena.h"
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef __TBB_STATISTICS
+#define __TBB_STATISTICS 0
+#endif
+
+#if __TBB_STATISTICS
+    #define GATHER_STATISTIC(x) (x)
+#else
+    #define GATHER_STATISTIC(x) ((void)0)
+#endif
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+#if __TBB_STATISTICS
+//! Scheduler activity counters of a single arena slot.
+/** Modified only by the thread occupying the slot, so increments need no read-modify-write
+    operations. Read by any thread querying the statistics of the arena. **/
+class slot_statistics {
+    using counter_type = std::atomic<std::uint64_t>;
+
+    static void increment(counter_type& counter, std::uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    counter_type my_tasks_spawned;
+    counter_type my_tasks_executed;
+    counter_type my_tasks_stolen;
+    counter_type my_failed_steal_attempts;
+    counter_type my_mailbox_hits;
+    counter_type my_proxies_dropped;
+    counter_type my_worker_pause_time_ns;
+
+public:
+    void task_spawned(std::uint64_t num_tasks = 1) { increment(my_tasks_spawned, num_tasks); }
+    void task_executed() { increment(my_tasks_executed, 1); }
+    void task_stolen() { increment(my_tasks_stolen, 1); }
+    void steal_failed() { increment(my_failed_steal_attempts, 1); }
+    void mailbox_hit() { increment(my_mailbox_hits, 1); }
+    void proxy_dropped() { increment(my_proxies_dropped, 1); }
+    void worker_paused(std::uint64_t ns) { increment(my_worker_pause_time_ns, ns); }
+
+    //! Adds the slot counters to the arena-wide ones
+    void accumulate(d1::arena_statistics& stats) const {
+        stats.tasks_spawned += my_tasks_spawned.load(std::memory_order_relaxed);
+        stats.tasks_executed += my_tasks_executed.load(std::memory_order_relaxed);
+        stats.tasks_stolen += my_tasks_stolen.load(std::memory_order_relaxed);
+        stats.failed_steal_attempts += my_failed_steal_attempts.load(std::memory_order_relaxed);
+        stats.mailbox_hits += my_mailbox_hits.load(std::memory_order_relaxed);
+        stats.proxies_dropped += my_proxies_dropped.load(std::memory_order_relaxed);
+        stats.worker_pause_time_ns += my_worker_pause_time_ns.load(std::memory_order_relaxed);
+    }
+};
+#endif /* __TBB_STATISTICS */
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_statistics_H */
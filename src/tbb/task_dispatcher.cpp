@@ -27,6 +27,24 @@ static inline void spawn_and_notify(d1::task& t, arena_slot* slot, arena* a) {
     // TODO: TBB_REVAMP_TODO slot->assert_task_pool_valid();
 }
 
+//! Wraps the task into a proxy that is to be placed both in the local pool and in the mailbox
+static inline task_proxy* allocate_proxy(thread_data& tls, d1::task& t, d1::slot_id id, isolation_type isolation) {
+    d1::small_object_pool* alloc{};
+    auto object_pool = tls.my_small_object_pool;
+    auto proxy = static_cast<task_proxy*>(object_pool->allocate_impl(alloc, sizeof(task_proxy)));
+    // Mark as a proxy
+    task_accessor::set_proxy_trait(*proxy);
+    // Mark isolation for the proxy task
+    task_accessor::isolation(*proxy) = isolation;
+    // Deallocation hint (tls) from the task allocator
+    proxy->allocator = alloc;
+    proxy->slot = id;
+    proxy->outbox = &tls.my_arena->mailbox(id);
+    // Mark proxy as present in both locations (sender's task pool and destination mailbox)
+    proxy->task_and_tag = intptr_t(&t) | task_proxy::location_mask;
+    return proxy;
+}
+
 void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx) {
     thread_data* tls = governor::get_thread_data();
     task_group_context_impl::bind_to(ctx, tls);
@@ -36,6 +54,7 @@ void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx) {
     task_accessor::context(t) = &ctx;
     // Mark isolation
     task_accessor::isolation(t) = tls->my_task_dispatcher->m_execute_data_ext.isolation;
+    RECORD_TRACE_EVENT(*tls, spawn, 1);
     spawn_and_notify(t, slot, a);
 }
 
@@ -50,22 +69,10 @@ void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::slo
     // Mark isolation
     isolation_type isolation = tls->my_task_dispatcher->m_execute_data_ext.isolation;
     task_accessor::isolation(t) = isolation;
+    RECORD_TRACE_EVENT(*tls, spawn, 1);
 
     if ( id != d1::no_slot && id != tls->my_arena_index ) {
-        // Allocate proxy task
-        d1::small_object_pool* alloc{};
-        auto object_pool = tls->my_small_object_pool;
-        auto proxy = static_cast<task_proxy*>(object_pool->allocate_impl(alloc, sizeof(task_proxy)));
-        // Mark as a proxy
-        task_accessor::set_proxy_trait(*proxy);
-        // Mark isolation for the proxy task
-        task_accessor::isolation(*proxy) = isolation;
-        // Deallocation hint (tls) from the task allocator
-        proxy->allocator = alloc;
-        proxy->slot = id;
-        proxy->outbox = &a->mailbox(id);
-        // Mark proxy as present in both locations (sender's task pool and destination mailbox)
-        proxy->task_and_tag = intptr_t(&t) | task_proxy::location_mask;
+        task_proxy* proxy = allocate_proxy(*tls, t, id, isolation);
         // Mail the proxy - after this point t may be destroyed by another thread at any moment.
         proxy->outbox->push(proxy);
         // Spawn proxy to the local task pool
@@ -75,6 +82,111 @@ void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::slo
     }
 }
 
+void __TBB_EXPORTED_FUNC spawn(d1::task* const* tasks, std::size_t num_tasks, d1::task_group_context& ctx) {
+    if (num_tasks == 0) {
+        return;
+    }
+    thread_data* tls = governor::get_thread_data();
+    task_group_context_impl::bind_to(ctx, tls);
+    arena* a = tls->my_arena;
+    arena_slot* slot = tls->my_arena_slot;
+    isolation_type isolation = tls->my_task_dispatcher->m_execute_data_ext.isolation;
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        // Capture current context
+        task_accessor::context(*tasks[i]) = &ctx;
+        // Mark isolation
+        task_accessor::isolation(*tasks[i]) = isolation;
+    }
+    RECORD_TRACE_EVENT(*tls, spawn, num_tasks);
+    // One publication and one notification for the whole batch
+    slot->spawn(tasks, num_tasks);
+    a->advertise_new_work<arena::work_spawned>();
+}
+
+d1::task* __TBB_EXPORTED_FUNC spawn_deferred_mail(d1::task& t, d1::task_group_context& ctx, d1::slot_id id) {
+    thread_data* tls = governor::get_thread_data();
+    task_group_context_impl::bind_to(ctx, tls);
+    arena* a = tls->my_arena;
+    arena_slot* slot = tls->my_arena_slot;
+    isolation_type isolation = tls->my_task_dispatcher->m_execute_data_ext.isolation;
+    // Capture context
+    task_accessor::context(t) = &ctx;
+    // Mark isolation
+    task_accessor::isolation(t) = isolation;
+    RECORD_TRACE_EVENT(*tls, spawn, 1);
+
+    // Nobody reads the mailbox of a vacant slot, so the proxy would only double the work
+    if (id == d1::no_slot || id == tls->my_arena_index || id >= a->my_num_slots || !a->my_slots[id].is_occupied()) {
+        spawn_and_notify(t, slot, a);
+        return nullptr;
+    }
+    task_proxy* proxy = allocate_proxy(*tls, t, id, isolation);
+    // The proxy is not freed until it is taken from the mailbox as well, so it stays valid
+    // until mail_proxies even if the task is executed and destroyed in the meantime.
+    spawn_and_notify(*proxy, slot, a);
+    return proxy;
+}
+
+void __TBB_EXPORTED_FUNC mail_proxies(d1::task* const* proxies, std::size_t num_proxies) {
+    constexpr std::size_t max_batch_size = 64;
+    // The chains of proxies mailed to the same slot
+    mail_outbox* outboxes[max_batch_size];
+    task_proxy* outbox_first[max_batch_size];
+    task_proxy* outbox_last[max_batch_size];
+    for (std::size_t begin = 0; begin < num_proxies; begin += max_batch_size) {
+        std::size_t batch_size = num_proxies - begin < max_batch_size ? num_proxies - begin : max_batch_size;
+        std::size_t num_outboxes = 0;
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            task_proxy* proxy = static_cast<task_proxy*>(proxies[begin + i]);
+            __TBB_ASSERT(task_accessor::is_proxy_task(*proxy), "Only the proxies returned by spawn_deferred_mail can be mailed");
+            std::size_t k = 0;
+            while (k < num_outboxes && outboxes[k] != proxy->outbox) {
+                ++k;
+            }
+            if (k == num_outboxes) {
+                outboxes[k] = proxy->outbox;
+                outbox_first[k] = proxy;
+                ++num_outboxes;
+            } else {
+                outbox_last[k]->next_in_mailbox.store(proxy, std::memory_order_relaxed);
+            }
+            outbox_last[k] = proxy;
+        }
+        // Mail the proxies - after this point they may be freed by another thread at any moment.
+        for (std::size_t k = 0; k < num_outboxes; ++k) {
+            outboxes[k]->push(outbox_first[k], outbox_last[k]);
+        }
+    }
+}
+
+void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::task_priority priority) {
+    thread_data* tls = governor::get_thread_data();
+    task_group_context_impl::bind_to(ctx, tls);
+    arena* a = tls->my_arena;
+    arena_slot* slot = tls->my_arena_slot;
+    // Capture current context
+    task_accessor::context(t) = &ctx;
+    // Mark isolation
+    task_accessor::isolation(t) = tls->my_task_dispatcher->m_execute_data_ext.isolation;
+    RECORD_TRACE_EVENT(*tls, spawn, 1);
+
+    switch (priority) {
+#if __TBB_PREVIEW_CRITICAL_TASKS
+    case d1::task_priority::high:
+        // Critical tasks are taken ahead of the local task pools of all threads in the arena.
+        a->my_critical_task_stream.push(&t, subsequent_lane_selector(slot->critical_hint()));
+        break;
+#endif
+    case d1::task_priority::low:
+        a->my_low_priority_task_stream.push(&t, subsequent_lane_selector(slot->low_priority_hint()));
+        break;
+    // Without the critical task stream task_priority::high falls back to the normal spawn
+    default:
+        slot->spawn(t);
+    }
+    a->advertise_new_work<arena::work_spawned>();
+}
+
 void __TBB_EXPORTED_FUNC submit(d1::task& t, d1::task_group_context& ctx, arena* a, std::uintptr_t as_critical) {
     suppress_unused_warning(as_critical);
     assert_pointer_valid(a);
@@ -154,6 +154,7 @@ inline d1::task* task_dispatcher::steal_or_get_critical(
     isolation_type isolation, bool critical_allowed)
 {
     if (d1::task* t = a.steal_task(arena_index, random, ed, isolation)) {
+        RECORD_TRACE_EVENT(*ed.task_disp->m_thread_data, steal, ed.original_slot);
         ed.context = task_accessor::context(*t);
         ed.isolation = task_accessor::isolation(*t);
         return get_critical_task(t, ed, isolation, critical_allowed);
@@ -204,6 +205,9 @@ d1::task* task_dispatcher::receive_or_steal_task(
         else if (t = get_stream_or_critical_task(ed, a, resume_stream, resume_hint, isolation, critical_allowed)) {
             // Successfully got the resume or critical task
         }
+        else if (fifo_allowed && isolation == no_isolation && (t = a.get_deadline_task())) {
+            // Enqueued tasks with deadlines are taken in the earliest-deadline-first order ahead of the FIFO ones.
+        }
         else if (fifo_allowed && isolation == no_isolation
                  && (t = get_stream_or_critical_task(ed, a, fifo_stream, fifo_hint, isolation, critical_allowed))) {
             // Checked if there are tasks in starvation-resistant stream. Only allowed at the outermost dispatch level without isolation.
@@ -212,14 +216,18 @@ d1::task* task_dispatcher::receive_or_steal_task(
                  && (t = steal_or_get_critical(ed, a, arena_index, tls.my_random, isolation, critical_allowed))) {
             // Stole a task from a random arena slot
         }
-        else {
-            t = get_critical_task(t, ed, isolation, critical_allowed);
+        else if (t = get_critical_task(t, ed, isolation, critical_allowed)) {
+            // Successfully got a critical task
+        }
+        else if (stealing_is_allowed && (t = a.get_low_priority_task(slot.low_priority_hint(), isolation))) {
+            // Nothing else to do, so took a low priority task. Like stealing, it is not allowed
+            // when the thread waits for its own tasks only.
         }
 
         if (t != nullptr) {
             ed.context = task_accessor::context(*t);
             ed.isolation = task_accessor::isolation(*t);
-            a.my_observers.notify_entry_observers(tls.my_last_observer, tls.my_is_worker);
+            a.my_observers.notify_entry_observers(tls.my_last_observer, tls.my_last_observer_epoch, tls.my_is_worker);
             break; // Stealing success, end of stealing attempt
         }
         // Nothing to do, pause a little.
@@ -307,7 +315,10 @@ d1::task* task_dispatcher::local_wait_for_all(d1::task* t, Waiter& waiter ) {
                     if (ed.context->is_group_execution_cancelled()) {
                         t = t->cancel(ed);
                     } else {
+                        GATHER_STATISTIC(m_thread_data->my_arena_slot->statistics().task_executed());
+                        RECORD_TRACE_EVENT(*m_thread_data, execute_begin, 0);
                         t = t->execute(ed);
+                        RECORD_TRACE_EVENT(*m_thread_data, execute_end, 0);
                     }
 
                     ITT_CALLEE_LEAVE(ITTPossible, itt_caller);
@@ -342,6 +353,8 @@ d1::task* task_dispatcher::local_wait_for_all(d1::task* t, Waiter& waiter ) {
             } while (t != nullptr); // main dispatch loop
             break; // Exit exception loop;
         } catch (...) {
+            // The task execution has been interrupted by the exception
+            RECORD_TRACE_EVENT(*m_thread_data, execute_end, 0);
             if (global_control::active_value(global_control::terminate_on_exception) == 1) {
                 do_throw_noexcept([] { throw; });
             }
@@ -415,7 +428,7 @@ inline d1::task* task_dispatcher::get_critical_task(d1::task* t, execution_data_
         m_properties.critical_task_allowed = false;
 
         // TODO: add a test that the observer is called when critical task is taken.
-        a.my_observers.notify_entry_observers(td.my_last_observer, td.my_is_worker);
+        a.my_observers.notify_entry_observers(td.my_last_observer, td.my_last_observer_epoch, td.my_is_worker);
         t = crit_t;
     } else {
         // Was unable to find critical work in the queue. Allow inspecting the queue in nested
@@ -435,10 +448,13 @@ inline d1::task* task_dispatcher::get_mailbox_task(mail_inbox& my_inbox, executi
         if (d1::task* result = tp->extract_task<task_proxy::mailbox_bit>()) {
             ed.original_slot = (unsigned short)(-2);
             ed.affinity_slot = ed.task_disp->m_thread_data->my_arena_index;
+            GATHER_STATISTIC(ed.task_disp->m_thread_data->my_arena_slot->statistics().mailbox_hit());
+            RECORD_TRACE_EVENT(*ed.task_disp->m_thread_data, mailbox_take, 0);
             return result;
         }
         // We have exclusive access to the proxy, and can destroy it.
         deallocate(*tp->allocator, tp, sizeof(*tp));
+        GATHER_STATISTIC(ed.task_disp->m_thread_data->my_arena_slot->statistics().proxy_dropped());
     }
     return NULL;
 }
@@ -60,7 +60,6 @@ void task_group_context_impl::destroy(d1::task_group_context& ctx) {
             thread_data::context_list_state& cls = owner->my_context_list_state;
             // We are the owner, so cls is valid.
             // Local update of the context list
-            std::uintptr_t local_count_snapshot = cls.epoch.load(std::memory_order_relaxed);
             // The sequentially-consistent store to prevent load of nonlocal update flag
             // from being hoisted before the store to local update flag.
             cls.local_update = 1;
@@ -74,13 +73,6 @@ void task_group_context_impl::destroy(d1::task_group_context& ctx) {
                 // the context list was committed when possible concurrent destroyer
                 // proceeds after local update flag is reset by the following store.
                 cls.local_update.store(0, std::memory_order_release);
-                if (local_count_snapshot != the_context_state_propagation_epoch.load(std::memory_order_relaxed)) {
-                    // Another thread was propagating cancellation request when we removed
-                    // ourselves from the list. We must ensure that it is not accessing us
-                    // when this destructor finishes. We'll be able to acquire the lock
-                    // below only after the other thread finishes with us.
-                    spin_mutex::scoped_lock lock(cls.mutex);
-                }
             }
         } else {
             d1::task_group_context::lifetime_state expected = d1::task_group_context::lifetime_state::bound;
@@ -149,6 +141,7 @@ void task_group_context_impl::initialize(d1::task_group_context& ctx) {
     ctx.my_node.next.store(nullptr, std::memory_order_relaxed);
     ctx.my_exception = nullptr;
     ctx.my_itt_caller = nullptr;
+    ctx.my_cancellation_epoch.store(0, std::memory_order_relaxed);
 
     static_assert(sizeof(d1::cpu_ctl_env) <= sizeof(ctx.my_cpu_ctl_env), "FPU settings storage does not fit to uint64_t");
     d1::cpu_ctl_env* ctl = new (&ctx.my_cpu_ctl_env) d1::cpu_ctl_env;
@@ -206,40 +199,12 @@ void task_group_context_impl::bind_to_impl(d1::task_group_context& ctx, thread_d
     if (ctx.my_parent->my_state.load(std::memory_order_relaxed) != d1::task_group_context::may_have_children) {
         ctx.my_parent->my_state.store(d1::task_group_context::may_have_children, std::memory_order_relaxed); // full fence is below
     }
-    if (ctx.my_parent->my_parent) {
-        // Even if this context were made accessible for state change propagation
-        // (by placing store_with_release(td->my_context_list_state.head.my_next, &ctx.my_node)
-        // above), it still could be missed if state propagation from a grand-ancestor
-        // was underway concurrently with binding.
-        // Speculative propagation from the parent together with epoch counters
-        // detecting possibility of such a race allow to avoid taking locks when
-        // there is no contention.
-
-        // Acquire fence is necessary to prevent reordering subsequent speculative
-        // loads of parent state data out of the scope where epoch counters comparison
-        // can reliably validate it.
-        uintptr_t local_count_snapshot = ctx.my_parent->my_owner.load(std::memory_order_relaxed)->my_context_list_state.epoch.load(std::memory_order_acquire);
-        // Speculative propagation of parent's state. The speculation will be
-        // validated by the epoch counters check further on.
-        ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
-        register_with(ctx, td); // Issues full fence
-
-        // If no state propagation was detected by the following condition, the above
-        // full fence guarantees that the parent had correct state during speculative
-        // propagation before the fence. Otherwise the propagation from parent is
-        // repeated under the lock.
-        if (local_count_snapshot != the_context_state_propagation_epoch.load(std::memory_order_relaxed)) {
-            // Another thread may be propagating state change right now. So resort to lock.
-            context_state_propagation_mutex_type::scoped_lock lock(the_context_state_propagation_mutex);
-            ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
-        }
-    } else {
-        register_with(ctx, td); // Issues full fence
-        // As we do not have grand-ancestors, concurrent state propagation (if any)
-        // may originate only from the parent context, and thus it is safe to directly
-        // copy the state from it.
-        ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
-    }
+    register_with(ctx, td); // Issues full fence
+    // The full fence above guarantees that either a concurrent cancellation of the parent
+    // observes the may_have_children state and advances the cancellation epoch, or the
+    // following load observes the cancellation. The cancellations of the further
+    // ancestors are detected on the first check because the epoch is not cached yet.
+    ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
 
     ctx.my_lifetime_state.store(d1::task_group_context::lifetime_state::bound, std::memory_order_release);
 }
@@ -277,47 +242,49 @@ void task_group_context_impl::bind_to(d1::task_group_context& ctx, thread_data*
     __TBB_ASSERT(ctx.my_lifetime_state.load(std::memory_order_relaxed) != d1::task_group_context::lifetime_state::locked, NULL);
 }
 
-template <typename T>
-void task_group_context_impl::propagate_task_group_state(d1::task_group_context& ctx, std::atomic<T> d1::task_group_context::* mptr_state, d1::task_group_context& src, T new_state) {
-    __TBB_ASSERT(!is_poisoned(ctx.my_owner), NULL);
-    if ((ctx.*mptr_state).load(std::memory_order_relaxed) == new_state) {
-        // Nothing to do, whether descending from "src" or not, so no need to scan.
-        // Hopefully this happens often thanks to earlier invocations.
-        // This optimization is enabled by LIFO order in the context lists:
-        // - new contexts are bound to the beginning of lists;
-        // - descendants are newer than ancestors;
-        // - earlier invocations are therefore likely to "paint" long chains.
-    } else if (&ctx == &src) {
-        // This clause is disjunct from the traversal below, which skips src entirely.
-        // Note that src.*mptr_state is not necessarily still equal to new_state (another thread may have changed it again).
-        // Such interference is probably not frequent enough to aim for optimisation by writing new_state again (to make the other thread back down).
-        // Letting the other thread prevail may also be fairer.
-    } else {
-        for (d1::task_group_context* ancestor = ctx.my_parent; ancestor != NULL; ancestor = ancestor->my_parent) {
-            if (ancestor == &src) {
-                for (d1::task_group_context* c = &ctx; c != ancestor; c = c->my_parent)
-                    (c->*mptr_state).store(new_state, std::memory_order_relaxed);
-                break;
-            }
-        }
-    }
-}
-
 bool task_group_context_impl::cancel_group_execution(d1::task_group_context& ctx) {
     __TBB_ASSERT(!is_poisoned(ctx.my_owner), NULL);
     __TBB_ASSERT(ctx.my_cancellation_requested.load(std::memory_order_relaxed) <= 1, "The cancellation state can be either 0 or 1");
     if (ctx.my_cancellation_requested.load(std::memory_order_relaxed) || ctx.my_cancellation_requested.exchange(1)) {
         // This task group and any descendants have already been canceled.
-        // (A newly added descendant would inherit its parent's ctx.my_cancellation_requested,
-        // not missing out on any cancellation still being propagated, and a context cannot be uncanceled.)
+        // (A newly added descendant checks its ancestors on the first use, and a context cannot be uncanceled.)
         return false;
     }
-    governor::get_thread_data()->my_arena->my_market->propagate_task_group_state(&d1::task_group_context::my_cancellation_requested, ctx, uint32_t(1));
+    if (ctx.my_state.load(std::memory_order_relaxed) == d1::task_group_context::may_have_children) {
+        // The descendants do not need to be found: they check their ancestors again
+        // when they observe the new epoch.
+        the_context_cancellation_epoch.fetch_add(1);
+    }
     return true;
 }
 
-bool task_group_context_impl::is_group_execution_cancelled(const d1::task_group_context& ctx) {
-    return ctx.my_cancellation_requested.load(std::memory_order_relaxed) != 0;
+bool task_group_context_impl::is_group_execution_cancelled(d1::task_group_context& ctx) {
+    if (ctx.my_cancellation_requested.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (ctx.my_parent == nullptr) {
+        return false;
+    }
+    // Acquire synchronizes with the epoch increment, so the cancellation that advanced
+    // the epoch is visible in the ancestors.
+    std::uintptr_t epoch = the_context_cancellation_epoch.load(std::memory_order_acquire);
+    if (ctx.my_cancellation_epoch.load(std::memory_order_relaxed) == epoch + 1) {
+        // No context has been cancelled since the last check of the ancestors.
+        return false;
+    }
+    for (d1::task_group_context* ancestor = ctx.my_parent; ancestor != nullptr; ancestor = ancestor->my_parent) {
+        if (ancestor->my_cancellation_requested.load(std::memory_order_relaxed)) {
+            // Paint the chain so that the other descendants of the intermediate contexts
+            // find the cancellation sooner. A context cannot be uncanceled, so the
+            // concurrent painting of the same chain is harmless.
+            for (d1::task_group_context* c = &ctx; c != ancestor; c = c->my_parent) {
+                c->my_cancellation_requested.store(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    ctx.my_cancellation_epoch.store(epoch + 1, std::memory_order_relaxed);
+    return false;
 }
 
 // IMPORTANT: It is assumed that this method is not used concurrently!
@@ -330,6 +297,9 @@ void task_group_context_impl::reset(d1::task_group_context& ctx) {
         ctx.my_exception->destroy();
         ctx.my_exception = NULL;
     }
+    // Only the own flag is cleared. The ancestors are checked again by
+    // is_group_execution_cancelled, so a context with a cancelled ancestor
+    // becomes cancelled again on the next check.
     ctx.my_cancellation_requested = 0;
 }
 
@@ -357,52 +327,6 @@ void task_group_context_impl::copy_fp_settings(d1::task_group_context& ctx, cons
     ctx.my_traits.fp_settings = true;
 }
 
-template <typename T>
-void thread_data::propagate_task_group_state(std::atomic<T> d1::task_group_context::* mptr_state, d1::task_group_context& src, T new_state) {
-    spin_mutex::scoped_lock lock(my_context_list_state.mutex);
-    // Acquire fence is necessary to ensure that the subsequent node->my_next load
-    // returned the correct value in case it was just inserted in another thread.
-    // The fence also ensures visibility of the correct ctx.my_parent value.
-    d1::context_list_node* node = my_context_list_state.head.next.load(std::memory_order_acquire);
-    while (node != &my_context_list_state.head) {
-        d1::task_group_context& ctx = __TBB_get_object_ref(d1::task_group_context, my_node, node);
-        if ((ctx.*mptr_state).load(std::memory_order_relaxed) != new_state)
-            task_group_context_impl::propagate_task_group_state(ctx, mptr_state, src, new_state);
-        node = node->next.load(std::memory_order_relaxed);
-    }
-    // Sync up local propagation epoch with the global one. Release fence prevents
-    // reordering of possible store to *mptr_state after the sync point.
-    my_context_list_state.epoch.store(the_context_state_propagation_epoch.load(std::memory_order_relaxed), std::memory_order_release);
-}
-
-template <typename T>
-bool market::propagate_task_group_state(std::atomic<T> d1::task_group_context::* mptr_state, d1::task_group_context& src, T new_state) {
-    if (src.my_state.load(std::memory_order_relaxed) != d1::task_group_context::may_have_children)
-        return true;
-    // The whole propagation algorithm is under the lock in order to ensure correctness
-    // in case of concurrent state changes at the different levels of the context tree.
-    // See comment at the bottom of scheduler.cpp
-    context_state_propagation_mutex_type::scoped_lock lock(the_context_state_propagation_mutex);
-    if ((src.*mptr_state).load(std::memory_order_relaxed) != new_state)
-        // Another thread has concurrently changed the state. Back down.
-        return false;
-    // Advance global state propagation epoch
-    ++the_context_state_propagation_epoch;
-    // Propagate to all workers and masters and sync up their local epochs with the global one
-    unsigned num_workers = my_first_unused_worker_idx;
-    for (unsigned i = 0; i < num_workers; ++i) {
-        thread_data* td = my_workers[i];
-        // If the worker is only about to be registered, skip it.
-        if (td)
-            td->propagate_task_group_state(mptr_state, src, new_state);
-    }
-    // Propagate to all master threads
-    // The whole propagation sequence is locked, thus no contention is expected
-    for (thread_data_list_type::iterator it = my_masters.begin(); it != my_masters.end(); it++)
-        it->propagate_task_group_state(mptr_state, src, new_state);
-    return true;
-}
-
 /*
     Comments:
 
@@ -418,43 +342,34 @@ bool market::propagate_task_group_state(std::atomic<T> d1::task_group_context::*
     are represented as lists of contexts, members of which are contexts that were
     bound to their parents in the given thread.
 
-    The context tree maintenance and cancellation propagation algorithms are designed
-    in such a manner that cross-thread access to a context list will take place only
-    when cancellation signal is sent (by user or when an exception happens), and
-    synchronization is necessary only then. Thus the normal execution flow (without
-    exceptions and cancellation) remains free from any synchronization done on
-    behalf of exception handling and cancellation support.
+    The lists are used only to detach the contexts from the finished threads. The
+    cancellation is not propagated through them: cancelling a context sets its own flag
+    and advances the global cancellation epoch, and each descendant notices the
+    cancellation by walking the chain of its ancestors when it is checked next time.
+    The walk is skipped while the global epoch is equal to the one cached in the
+    context, so the normal execution flow (without cancellations) remains free from
+    any synchronization done on behalf of exception handling and cancellation support,
+    and a cancellation never stalls the threads that do not check the affected contexts.
 
 2.  Consider parallel cancellations at the different levels of the context tree:
 
-        Ctx1 <- Cancelled by Thread1            |- Thread2 started processing
-         |                                      |
-        Ctx2                                    |- Thread1 started processing
-         |                                   T1 |- Thread2 finishes and syncs up local counters
-        Ctx3 <- Cancelled by Thread2            |
-         |                                      |- Ctx5 is bound to Ctx2
-        Ctx4                                    |
-                                             T2 |- Thread1 reaches Ctx2
-
-    Thread-propagator of each cancellation increments global counter. However the thread
-    propagating the cancellation from the outermost context (Thread1) may be the last
-    to finish. Which means that the local counters may be synchronized earlier (by Thread2,
-    at Time1) than it propagated cancellation into Ctx2 (at time Time2). If a new context
-    (Ctx5) is created and bound to Ctx2 between Time1 and Time2, checking its parent only
-    (Ctx2) may result in cancellation request being lost.
-
-    This issue is solved by doing the whole propagation under the lock.
-
-    If we need more concurrency while processing parallel cancellations, we could try
-    the following modification of the propagation algorithm:
-
-    advance global counter and remember it
-    for each thread:
-        scan thread's list of contexts
-    for each thread:
-        sync up its local counter only if the global counter has not been changed
-
-    However this version of the algorithm requires more analysis and verification.
+        Ctx1 <- Cancelled by Thread1
+         |
+        Ctx2
+         |
+        Ctx3 <- Cancelled by Thread2
+         |
+        Ctx4 <- Checked by Thread3
+
+    Each canceller stores its flag before advancing the epoch, and Thread3 loads the
+    epoch before walking the ancestors. Thus if Thread3 caches an epoch, the walk has
+    observed all the cancellations that happened before that epoch, and any later
+    cancellation changes the epoch and forces another walk. Nothing is cached when a
+    cancelled ancestor is found: the flags of the contexts on the way to it are set
+    instead, so their other descendants find the cancellation in fewer steps.
+
+    A context bound after its ancestors have been cancelled has no cached epoch yet,
+    so its first check walks the whole chain as well.
 */
 
 void __TBB_EXPORTED_FUNC initialize(d1::task_group_context& ctx) {
@@ -36,6 +36,10 @@
 #include <climits>
 #include <atomic>
 
+#ifndef __TBB_LOCK_FREE_TASK_STREAM
+#define __TBB_LOCK_FREE_TASK_STREAM 0
+#endif
+
 namespace tbb {
 namespace detail {
 namespace r1 {
@@ -280,6 +284,199 @@ private:
 
 }; // task_stream
 
+#if __TBB_LOCK_FREE_TASK_STREAM
+//! Lane of a task stream built around a bounded lock-free MPMC ring buffer.
+/** When the ring is full, tasks go to a mutex-protected overflow queue and keep going there
+    until it is drained, so the lane remains FIFO. **/
+class lock_free_lane : no_copy {
+    static constexpr std::size_t ring_size = 64;
+    static_assert(((ring_size - 1) & ring_size) == 0, "The ring size must be a power of two");
+
+    //! Ring buffer element. The sequence tells which lap of the ring the element belongs to.
+    struct cell {
+        std::atomic<std::size_t> sequence;
+        d1::task* task;
+    };
+
+    alignas(max_nfs_size) std::atomic<std::size_t> my_enqueue_pos{0};
+    alignas(max_nfs_size) std::atomic<std::size_t> my_dequeue_pos{0};
+    //! The number of tasks in the overflow queue, to check it without locking
+    alignas(max_nfs_size) std::atomic<std::size_t> my_overflow_size{0};
+    queue_and_mutex<d1::task*, spin_mutex> my_overflow;
+    cell my_ring[ring_size];
+
+    bool ring_push(d1::task* t) {
+        std::size_t pos = my_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell& c = my_ring[pos & (ring_size - 1)];
+            std::size_t seq = c.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos);
+            if (diff == 0) {
+                if (my_enqueue_pos.compare_exchange_weak(pos, pos + 1)) {
+                    c.task = t;
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // The ring is full
+                return false;
+            } else {
+                pos = my_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    d1::task* ring_pop() {
+        std::size_t pos = my_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell& c = my_ring[pos & (ring_size - 1)];
+            std::size_t seq = c.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos + 1);
+            if (diff == 0) {
+                if (my_dequeue_pos.compare_exchange_weak(pos, pos + 1)) {
+                    d1::task* t = c.task;
+                    c.sequence.store(pos + ring_size, std::memory_order_release);
+                    return t;
+                }
+            } else if (diff < 0) {
+                // The ring is empty or the element is not written yet
+                return nullptr;
+            } else {
+                pos = my_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    lock_free_lane() {
+        for (std::size_t i = 0; i < ring_size; ++i) {
+            my_ring[i].sequence.store(i, std::memory_order_relaxed);
+            my_ring[i].task = nullptr;
+        }
+    }
+
+    //! Returns false if the task has to go to the overflow queue which is locked by another thread.
+    bool try_push(d1::task* t) {
+        if (my_overflow_size.load(std::memory_order_relaxed) == 0 && ring_push(t)) {
+            return true;
+        }
+        spin_mutex::scoped_lock lock;
+        if (!lock.try_acquire(my_overflow.my_mutex)) {
+            return false;
+        }
+        my_overflow.my_queue.push_back(t);
+        my_overflow_size.store(my_overflow.my_queue.size());
+        return true;
+    }
+
+    //! Returns nullptr if the lane is empty or its overflow queue is locked by another thread.
+    d1::task* try_pop() {
+        if (d1::task* t = ring_pop()) {
+            return t;
+        }
+        if (my_overflow_size.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        spin_mutex::scoped_lock lock;
+        if (!lock.try_acquire(my_overflow.my_mutex) || my_overflow.my_queue.empty()) {
+            return nullptr;
+        }
+        d1::task* t = my_overflow.my_queue.front();
+        my_overflow.my_queue.pop_front();
+        my_overflow_size.store(my_overflow.my_queue.size());
+        return t;
+    }
+
+    //! Sequentially consistent check, so it can be ordered with the population bit changes.
+    bool empty() const {
+        // The dequeue position is read first since it never overtakes the enqueue position.
+        std::size_t dequeue_pos = my_dequeue_pos.load();
+        return dequeue_pos == my_enqueue_pos.load() && my_overflow_size.load() == 0;
+    }
+};
+
+//! The container for "fairness-oriented" aka "enqueued" tasks based on lock-free lanes.
+/** Front accessor streams use neither the isolation-aware lookup nor the retrieval from the back,
+    so their lanes do not need to be protected by a mutex. **/
+template<>
+class task_stream<front_accessor> : no_copy {
+    using lane_t = lock_free_lane;
+    std::atomic<population_t> population{};
+    lane_t* lanes{nullptr};
+    unsigned N{};
+
+public:
+    task_stream() = default;
+
+    void initialize( unsigned n_lanes ) {
+        const unsigned max_lanes = sizeof(population_t) * CHAR_BIT;
+
+        N = n_lanes >= max_lanes ? max_lanes : n_lanes > 2 ? 1 << (tbb::detail::log2(n_lanes - 1) + 1) : 2;
+        __TBB_ASSERT( N == max_lanes || N >= n_lanes && ((N - 1) & N) == 0, "number of lanes miscalculated" );
+        lanes = static_cast<lane_t*>(cache_aligned_allocate(sizeof(lane_t) * N));
+        for (unsigned i = 0; i < N; ++i) {
+            new (lanes + i) lane_t;
+        }
+        __TBB_ASSERT( !population.load(std::memory_order_relaxed), NULL );
+    }
+
+    ~task_stream() {
+        __TBB_ASSERT(lanes, "Initialize wasn't called");
+        for (unsigned i = 0; i < N; ++i) {
+            lanes[i].~lane_t();
+        }
+        cache_aligned_deallocate(lanes);
+    }
+
+    //! Push a task into a lane. Lane selection is performed by passed functor.
+    template<typename lane_selector_t>
+    void push(d1::task* source, const lane_selector_t& next_lane ) {
+        unsigned lane = 0;
+        do {
+            lane = next_lane( /*out_of=*/N );
+            __TBB_ASSERT( lane < N, "Incorrect lane index." );
+        } while( !lanes[lane].try_push( source ) );
+        // The bit is set after the task is in the lane, see try_pop for the other side.
+        set_one_bit( population, lane );
+    }
+
+    //! Try finding and popping a task using passed functor for lane selection. Last used lane is
+    //! updated inside lane selector.
+    template<typename lane_selector_t>
+    d1::task* pop( const lane_selector_t& next_lane ) {
+        d1::task* popped = NULL;
+        unsigned lane = 0;
+        do {
+            lane = next_lane( /*out_of=*/N );
+            __TBB_ASSERT( lane < N, "Incorrect lane index." );
+        } while( !empty() && !(popped = try_pop( lane )) );
+        return popped;
+    }
+
+    //! Checks existence of a task.
+    bool empty() {
+        return !population.load(std::memory_order_relaxed);
+    }
+
+private:
+    //! Returns pointer to task on successful pop, otherwise - NULL.
+    d1::task* try_pop( unsigned lane_idx ) {
+        if( !is_bit_set( population.load(std::memory_order_relaxed), lane_idx ) )
+            return NULL;
+        lane_t& lane = lanes[lane_idx];
+        d1::task* result = lane.try_pop();
+        if( lane.empty() ) {
+            clear_one_bit( population, lane_idx );
+            // A concurrent push might have set the bit before it was cleared. Since the push
+            // puts the task into the lane before setting the bit, the lane is not empty then.
+            if( !lane.empty() )
+                set_one_bit( population, lane_idx );
+        }
+        return result;
+    }
+}; // task_stream<front_accessor>
+#endif /* __TBB_LOCK_FREE_TASK_STREAM */
+
 } // namespace r1
 } // namespace detail
 } // namespace tbb
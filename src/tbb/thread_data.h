@@ -28,6 +28,7 @@
 #include "mailbox.h"
 #include "misc.h" // FastRandom
 #include "small_object_pool_impl.h"
+#include "scheduler_trace.h"
 
 #include <atomic>
 
@@ -56,12 +57,16 @@ public:
         , my_inbox{}
         , my_random{ this }
         , my_last_observer{ nullptr }
+        , my_last_observer_epoch{ 0 }
         , my_small_object_pool{new (cache_aligned_allocate(sizeof(small_object_pool_impl))) small_object_pool_impl{}}
         , my_context_list_state{}
 #if __TBB_RESUMABLE_TASKS
         , my_post_resume_action{ post_resume_action::none }
         , my_post_resume_arg{nullptr}
 #endif /* __TBB_RESUMABLE_TASKS */
+#if __TBB_SCHEDULER_TRACE
+        , my_trace_buffer{ acquire_trace_buffer(is_worker) }
+#endif /* __TBB_SCHEDULER_TRACE */
     {
         ITT_SYNC_CREATE(&my_context_list_state.mutex, SyncType_Scheduler, SyncObj_ContextsList);
         my_context_list_state.head.next.store(&my_context_list_state.head, std::memory_order_relaxed);
@@ -71,6 +76,10 @@ public:
     ~thread_data() {
         context_list_cleanup();
         my_small_object_pool->destroy();
+#if __TBB_SCHEDULER_TRACE
+        release_trace_buffer(my_trace_buffer);
+        poison_pointer(my_trace_buffer);
+#endif /* __TBB_SCHEDULER_TRACE */
         poison_pointer(my_task_dispatcher);
         poison_pointer(my_arena);
         poison_pointer(my_arena_slot);
@@ -79,7 +88,6 @@ public:
 #if __TBB_RESUMABLE_TASKS
         poison_pointer(my_post_resume_arg);
 #endif /* __TBB_RESUMABLE_TASKS */
-        poison_value(my_context_list_state.epoch);
         poison_value(my_context_list_state.local_update);
         poison_value(my_context_list_state.nonlocal_update);
     }
@@ -89,8 +97,6 @@ public:
     void attach_task_dispatcher(task_dispatcher&);
     void detach_task_dispatcher();
     void context_list_cleanup();
-    template <typename T>
-    void propagate_task_group_state(std::atomic<T> d1::task_group_context::* mptr_state, d1::task_group_context& src, T new_state);
 
     //! Index of the arena slot the scheduler occupies now, or occupied last time
     unsigned short my_arena_index;
@@ -116,6 +122,9 @@ public:
     //! Last observer in the observers list processed on this slot
     observer_proxy* my_last_observer;
 
+    //! Epoch of the observers list at the last entry notification; zero if none was done
+    std::uintptr_t my_last_observer_epoch;
+
     //! Pool of small object for fast task allocation
     small_object_pool_impl* my_small_object_pool;
 
@@ -127,15 +136,6 @@ public:
         // TODO: check whether it can be deadly preempted and replace by spinning/sleeping mutex
         spin_mutex mutex{};
 
-        //! Last state propagation epoch known to this thread
-        /** Together with the_context_state_propagation_epoch constitute synchronization protocol
-        that keeps hot path of task group context construction destruction mostly
-        lock-free.
-        When local epoch equals the global one, the state of task group contexts
-        registered with this thread is consistent with that of the task group trees
-        they belong to. **/
-        std::atomic<std::uintptr_t> epoch{};
-
         //! Flag indicating that a context is being destructed by its owner thread
         /** Together with my_nonlocal_ctx_list_update constitute synchronization protocol
         that keeps hot path of context destruction (by the owner thread) mostly
@@ -199,6 +199,11 @@ public:
     void* my_post_resume_arg;
 #endif /* __TBB_RESUMABLE_TASKS */
 
+#if __TBB_SCHEDULER_TRACE
+    //! The events recorded by the thread
+    trace_buffer* my_trace_buffer;
+#endif /* __TBB_SCHEDULER_TRACE */
+
     //! The default context
     // TODO: consider using common default context because it is used only to simplify
     // cancellation check.
@@ -211,6 +216,11 @@ inline void thread_data::attach_arena(arena& a, std::size_t index) {
     my_arena_slot = a.my_slots + index;
     // Read the current slot mail_outbox and attach it to the mail_inbox (remove inbox later maybe)
     my_inbox.attach(my_arena->mailbox(index));
+#if __TBB_NUMA_SUPPORT
+    if (a.my_numa_aware_stealing) {
+        my_arena_slot->set_numa_node(current_numa_node());
+    }
+#endif /*__TBB_NUMA_SUPPORT*/
 }
 
 inline bool thread_data::is_attached_to(arena* a) { return my_arena == a; }
@@ -18,8 +18,12 @@
 #define _TBB_waiters_H
 
 #include "oneapi/tbb/detail/_task.h"
+#include "oneapi/tbb/global_control.h"
 #include "scheduler_common.h"
 #include "arena.h"
+#include "thread_data.h"
+
+#include <chrono>
 
 namespace tbb {
 namespace detail {
@@ -51,7 +55,8 @@ protected:
 
 class outermost_worker_waiter : public waiter_base {
 public:
-    using waiter_base::waiter_base;
+    outermost_worker_waiter(arena& a)
+        : waiter_base(a), my_is_gap_recorded(false), my_join_time(std::chrono::steady_clock::now()) {}
 
     bool continue_execution(arena_slot& slot, d1::task*& t) const {
         __TBB_ASSERT(t == nullptr, nullptr);
@@ -65,8 +70,31 @@ public:
         return true;
     }
 
-    void pause(arena_slot&) {
-        waiter_base::pause();
+    void pause(arena_slot& slot) {
+#if __TBB_STATISTICS
+        auto start = std::chrono::steady_clock::now();
+        bool is_gap_too_long = waiter_base::pause();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        slot.statistics().worker_paused(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#else
+        suppress_unused_warning(slot);
+        bool is_gap_too_long = waiter_base::pause();
+#endif
+        if (is_gap_too_long && !my_is_gap_recorded) {
+            // The real duration of the gap is unknown, so account it as exceeding the spinning limit
+            my_arena.record_idle_gap(2 * policy_limits().max_yields);
+            my_is_gap_recorded = true;
+        }
+    }
+
+    void reset_wait() {
+        // The previous search for work has ended with a task, so its duration is known
+        if (my_backoff.has_paused() && !my_is_gap_recorded) {
+            my_arena.record_idle_gap(my_backoff.yield_count());
+        }
+        my_is_gap_recorded = false;
+        my_backoff.reset_wait();
+        my_backoff.set_yield_threshold(yield_threshold());
     }
 
 
@@ -81,6 +109,38 @@ public:
 private:
     using base_type = waiter_base;
 
+    struct spin_limits {
+        //! The number of yields made even if the recent idle gaps are short
+        int min_yields;
+        //! The number of yields that cover the longest idle gap worth spinning for
+        int max_yields;
+        //! Whether to keep spinning up to max_yields when the recent idle gaps are too long
+        bool spin_through_long_gaps;
+    };
+
+    static spin_limits policy_limits() {
+        constexpr int yields = stealing_loop_backoff::default_yield_threshold;
+        switch (wait_policy()) {
+        case global_control::wait_latency_first:
+            return { yields, 4 * yields, true };
+        case global_control::wait_power_first:
+            return { 0, yields / 10, false };
+        default:
+            return { yields / 10, yields, false };
+        }
+    }
+
+    //! Spins about twice as long as the recent idle gaps, so the waste does not exceed 2x the optimal spin.
+    /** If the gaps are longer than the policy allows to spin, there is no point to spin long. **/
+    int yield_threshold() const {
+        spin_limits limits = policy_limits();
+        int desired = 2 * my_arena.my_idle_gap_estimate.load(std::memory_order_relaxed);
+        if (desired > limits.max_yields) {
+            return limits.spin_through_long_gaps ? limits.max_yields : limits.min_yields;
+        }
+        return desired > limits.min_yields ? desired : limits.min_yields;
+    }
+
     bool is_worker_should_leave(arena_slot& slot) const {
         bool is_top_priority_arena = my_arena.my_is_top_priority.load(std::memory_order_relaxed);
         bool is_task_pool_empty = slot.task_pool.load(std::memory_order_relaxed) == EmptyTaskPool;
@@ -92,6 +152,9 @@ private:
             }
         } else {
             if (my_arena.is_recall_requested()) {
+                if (is_residency_required()) {
+                    return false;
+                }
                 // If worker has work in task pool, we must notify other threads,
                 // because can appear missed wake up of other threads
                 if (!is_task_pool_empty) {
@@ -103,6 +166,28 @@ private:
 
         return false;
     }
+
+    //! Whether the worker ignores the recall to avoid moving back and forth between arenas
+    /** Under the stable allotment policy, the worker stays in the arena that still has work
+        until the minimal residency time passes, so short bursts of demand in other arenas
+        do not make it migrate. **/
+    bool is_residency_required() const {
+        if (allotment_policy() != global_control::allotment_stable ||
+            my_arena.my_pool_state.load(std::memory_order_relaxed) == arena::SNAPSHOT_EMPTY) {
+            return false;
+        }
+        return std::chrono::steady_clock::now() - my_join_time < min_residency_time();
+    }
+
+    static constexpr std::chrono::microseconds min_residency_time() {
+        return std::chrono::microseconds(1000);
+    }
+
+    //! Whether the current idle gap has been already accounted in the arena estimate
+    bool my_is_gap_recorded;
+
+    //! The time when the worker has joined the arena
+    const std::chrono::steady_clock::time_point my_join_time;
 };
 
 class sleep_waiter : public waiter_base {
@@ -123,7 +208,10 @@ protected:
             wait_list.prepare_wait(thr_ctx, extended_context{uniq_tag, arena_tag});
 
             while (sleep_condition()) {
-                if (wait_list.commit_wait(thr_ctx)) {
+                RECORD_TRACE_EVENT(*governor::get_thread_data(), sleep_begin, 0);
+                bool is_notified = wait_list.commit_wait(thr_ctx);
+                RECORD_TRACE_EVENT(*governor::get_thread_data(), sleep_end, 0);
+                if (is_notified) {
                     return;
                 }
                 wait_list.prepare_wait(thr_ctx, extended_context{uniq_tag, arena_tag});
@@ -26,6 +26,7 @@
 #pragma warning( pop )
 #endif
 
+#include <algorithm>
 #include <vector>
 
 // Most of hwloc calls returns negative exit code on error.
@@ -40,6 +41,13 @@ namespace r1 {
 //------------------------------------------------------------------------
 // Information about the machine's hardware TBB is happen to work on
 //------------------------------------------------------------------------
+// The values of d1::task_arena_base::thread_pinning
+enum pinning_policy {
+    no_pinning = 0,
+    compact_pinning = 1,
+    scatter_pinning = 2
+};
+
 class platform_topology {
     friend class numa_affinity_handler;
 
@@ -48,6 +56,10 @@ class platform_topology {
     hwloc_cpuset_t   process_cpu_affinity_mask;
     hwloc_nodeset_t  process_node_affinity_mask;
     std::vector<hwloc_cpuset_t>  affinity_masks_list;
+    // The cores available to the process in the logical order; the scatter order lists
+    // the first cores of all the packages, then the second ones, and so on.
+    std::vector<hwloc_cpuset_t>  core_masks_list;
+    std::vector<int>             scatter_order;
 
     std::vector<int> default_concurrency_list;
     std::vector<int> numa_indexes_list;
@@ -132,6 +144,7 @@ public:
             default_concurrency_list.push_back(hwloc_bitmap_weight(process_cpu_affinity_mask));
 
             affinity_masks_list.push_back(hwloc_bitmap_dup(process_cpu_affinity_mask));
+            parse_cores();
             initialization_state = topology_parsed;
             return;
         }
@@ -170,10 +183,49 @@ public:
             __TBB_ASSERT(!hwloc_bitmap_iszero(current_mask), "hwloc detected unavailable NUMA node");
             default_concurrency_list[index] = hwloc_bitmap_weight(current_mask);
         } hwloc_bitmap_foreach_end();
+        parse_cores();
         initialization_state = topology_parsed;
     }
 
+    void parse_cores() {
+        // Some virtual machines do not report the cores, so the processing units are used instead
+        hwloc_obj_type_t core_type = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_CORE) > 0 ?
+            HWLOC_OBJ_CORE : HWLOC_OBJ_PU;
+        std::vector<int> package_indexes;
+        std::vector<int> positions_in_package;
+        hwloc_obj_t core = nullptr;
+        while ( (core = hwloc_get_next_obj_by_type(topology, core_type, core)) != nullptr ) {
+            hwloc_cpuset_t core_mask = hwloc_bitmap_dup(core->cpuset);
+            hwloc_bitmap_and(core_mask, core_mask, process_cpu_affinity_mask);
+            if ( hwloc_bitmap_iszero(core_mask) ) {
+                hwloc_bitmap_free(core_mask);
+                continue;
+            }
+            hwloc_obj_t package = hwloc_get_ancestor_obj_by_type(topology, HWLOC_OBJ_PACKAGE, core);
+            int package_index = package ? static_cast<int>(package->logical_index) : 0;
+            int position = static_cast<int>(std::count(package_indexes.begin(), package_indexes.end(), package_index));
+            core_masks_list.push_back(core_mask);
+            package_indexes.push_back(package_index);
+            positions_in_package.push_back(position);
+        }
+
+        scatter_order.resize(core_masks_list.size());
+        for ( std::size_t i = 0; i < scatter_order.size(); ++i ) {
+            scatter_order[i] = static_cast<int>(i);
+        }
+        std::stable_sort(scatter_order.begin(), scatter_order.end(),
+            [&positions_in_package, &package_indexes] (int lhs, int rhs) {
+                if ( positions_in_package[lhs] != positions_in_package[rhs] ) {
+                    return positions_in_package[lhs] < positions_in_package[rhs];
+                }
+                return package_indexes[lhs] < package_indexes[rhs];
+            });
+    }
+
     ~platform_topology() {
+        for ( std::size_t i = 0; i < core_masks_list.size(); ++i ) {
+            hwloc_bitmap_free(core_masks_list[i]);
+        }
         if ( is_topology_parsed() ) {
             for (int i = 0; i < numa_nodes_count; i++) {
                 hwloc_bitmap_free(affinity_masks_list[numa_indexes_list[i]]);
@@ -222,6 +274,56 @@ public:
             "Trying to get affinity mask for uninitialized NUMA node");
         return affinity_masks_list[node_index];
     }
+
+    // Returns the mask of the core for the slot, or nullptr if there are no suitable cores.
+    // Only the cores of the NUMA node are considered if numa_index is not negative.
+    const_affinity_mask get_core_affinity_mask( int slot_num, int numa_index, int policy ) {
+        __TBB_ASSERT(is_topology_parsed(), "Trying to get access to uninitialized platform_topology");
+        const_affinity_mask node_mask = nullptr;
+        if ( numa_index >= 0 && numa_index < (int)affinity_masks_list.size() ) {
+            node_mask = affinity_masks_list[numa_index];
+        }
+        std::size_t num_cores = 0;
+        for ( int pass = 0; pass < 2; ++pass ) {
+            // The first pass counts the suitable cores, the second one picks the core for the slot
+            std::size_t target = pass == 0 ? 0 : slot_num % num_cores;
+            std::size_t counter = 0;
+            for ( std::size_t i = 0; i < core_masks_list.size(); ++i ) {
+                hwloc_cpuset_t core_mask = core_masks_list[policy == scatter_pinning ? scatter_order[i] : i];
+                if ( node_mask && !hwloc_bitmap_intersects(node_mask, core_mask) ) {
+                    continue;
+                }
+                if ( pass == 1 && counter == target ) {
+                    return core_mask;
+                }
+                ++counter;
+            }
+            num_cores = counter;
+            if ( num_cores == 0 ) {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the logical index of the NUMA node the calling thread was last running on,
+    // or -1 if it cannot be determined.
+    int get_current_numa_index() {
+        __TBB_ASSERT(is_topology_parsed(), "Trying to get access to uninitialized platform_topology");
+        int result = -1;
+        hwloc_cpuset_t current_cpu = hwloc_bitmap_alloc();
+        if ( hwloc_get_last_cpu_location(topology, current_cpu, HWLOC_CPUBIND_THREAD) == 0 ) {
+            for ( int i = 0; i < numa_nodes_count; i++ ) {
+                int index = numa_indexes_list[i];
+                if ( index >= 0 && hwloc_bitmap_intersects(affinity_masks_list[index], current_cpu) ) {
+                    result = index;
+                    break;
+                }
+            }
+        }
+        hwloc_bitmap_free(current_cpu);
+        return result;
+    }
 };
 
 class binding_handler {
@@ -256,6 +358,23 @@ public:
             platform_topology::instance().get_node_affinity_mask(numa_node_id));
     }
 
+    void bind_thread_to_core( unsigned slot_num, int numa_node_id, int policy ) {
+        __TBB_ASSERT(slot_num < affinity_backup.size(),
+            "The slot number is greater than the number of slots in the arena");
+        __TBB_ASSERT(platform_topology::instance().is_topology_parsed(),
+            "Trying to get access to uninitialized platform_topology");
+        platform_topology::instance().store_current_affinity_mask(affinity_backup[slot_num]);
+
+        platform_topology::const_affinity_mask core_mask =
+            platform_topology::instance().get_core_affinity_mask(slot_num, numa_node_id, policy);
+        if ( core_mask ) {
+            platform_topology::instance().set_new_affinity_mask(core_mask);
+        } else if ( numa_node_id >= 0 ) {
+            platform_topology::instance().set_new_affinity_mask(
+                platform_topology::instance().get_node_affinity_mask(numa_node_id));
+        }
+    }
+
     void restore_previous_affinity_mask( unsigned slot_num ) {
         __TBB_ASSERT(platform_topology::instance().is_topology_parsed(),
             "Trying to get access to uninitialized platform_topology");
@@ -288,6 +407,14 @@ void __TBB_internal_bind_to_node(binding_handler* handler_ptr, int slot_num, int
     handler_ptr->bind_thread_to_node(slot_num, numa_id);
 }
 
+void __TBB_internal_bind_to_core(binding_handler* handler_ptr, int slot_num, int numa_id, int policy) {
+    __TBB_ASSERT(handler_ptr != nullptr, "Trying to get access to uninitialized metadata.");
+    __TBB_ASSERT(platform_topology::instance().is_topology_parsed(),
+        "Trying to get access to uninitialized platform_topology.");
+    __TBB_ASSERT(policy == compact_pinning || policy == scatter_pinning, "Unknown pinning policy.");
+    handler_ptr->bind_thread_to_core(slot_num, numa_id, policy);
+}
+
 void __TBB_internal_restore_affinity(binding_handler* handler_ptr, int slot_num) {
     __TBB_ASSERT(handler_ptr != nullptr, "Trying to get access to uninitialized metadata.");
     __TBB_ASSERT(platform_topology::instance().is_topology_parsed(),
@@ -295,6 +422,12 @@ void __TBB_internal_restore_affinity(binding_handler* handler_ptr, int slot_num)
     handler_ptr->restore_previous_affinity_mask(slot_num);
 }
 
+int __TBB_internal_get_current_numa_node() {
+    __TBB_ASSERT(platform_topology::instance().is_topology_parsed(),
+        "Trying to get access to uninitialized platform_topology.");
+    return platform_topology::instance().get_current_numa_index();
+}
+
 } // extern "C"
 
 } // namespace r1
@@ -22,6 +22,11 @@
 #include "common/memory_usage.h"
 
 #include "tbb/parallel_for.h"
+#include "tbb/tick_count.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
 
 #if __TBB_HWLOC_PRESENT
 void recursive_arena_binding(int* numa_indexes, size_t count,
@@ -83,6 +88,43 @@ TEST_CASE("Test constraints propagation during arenas copy construction") {
         }
     }
 }
+//! Testing that the pinned threads run on a single core each and get their affinity back
+//! \brief \ref interface \ref requirement
+TEST_CASE("Test thread pinning policies") {
+    if (is_system_environment_supported()) {
+        numa_validation::initialize_system_info();
+        using thread_pinning = tbb::task_arena::thread_pinning;
+        for (thread_pinning pinning: { thread_pinning::compact, thread_pinning::scatter }) {
+            numa_validation::affinity_mask mask_before = numa_validation::allocate_current_cpu_set();
+
+            tbb::task_arena::constraints constraints;
+            constraints.pinning = pinning;
+            tbb::task_arena arena(constraints);
+            const int num_slots = arena.max_concurrency();
+            std::vector<numa_validation::affinity_mask> slot_masks(num_slots);
+            arena.execute([&slot_masks, num_slots] {
+                utils::SpinBarrier barrier(num_slots);
+                tbb::parallel_for(tbb::blocked_range<int>(0, num_slots, 1), [&](const tbb::blocked_range<int>&) {
+                    int slot = tbb::this_task_arena::current_thread_index();
+                    slot_masks[slot] = numa_validation::allocate_current_cpu_set();
+                    barrier.wait();
+                }, tbb::simple_partitioner{});
+            });
+
+            // Each slot is pinned to a whole core, so the masks of the slots either match or do not intersect
+            for (int i = 0; i < num_slots; ++i) {
+                REQUIRE_MESSAGE(slot_masks[i] != nullptr, "Not all the slots were occupied");
+                for (int j = 0; j < i; ++j) {
+                    REQUIRE_MESSAGE((numa_validation::affinity_masks_isequal(slot_masks[i], slot_masks[j]) ||
+                        !numa_validation::affinity_masks_intersects(slot_masks[i], slot_masks[j])),
+                        "The slots are pinned to overlapping sets of cores");
+                }
+            }
+            REQUIRE_MESSAGE(numa_validation::affinity_masks_isequal(mask_before, numa_validation::allocate_current_cpu_set()),
+                "The affinity of the thread was not restored after leaving the pinned arena");
+        }
+    }
+}
 #endif /*__TBB_HWLOC_PRESENT*/
 
 void collect_all_threads_on_barrier() {
@@ -134,3 +176,65 @@ TEST_CASE("Test memory leaks") {
     }
     REQUIRE_MESSAGE(no_memory_leak, "Seems we get memory leak here.");
 }
+
+//! Testing that arenas with NUMA-aware stealing process all the work, including their copies
+//! \brief \ref interface \ref requirement
+TEST_CASE("Test NUMA-aware stealing") {
+    std::vector<int> numa_indexes = tbb::info::numa_nodes();
+    for (auto index: numa_indexes) {
+        tbb::task_arena::constraints constraints(index);
+        constraints.numa_aware_stealing = true;
+
+        tbb::task_arena constructed(constraints);
+        tbb::task_arena copied(constructed);
+        for (tbb::task_arena* arena: { &constructed, &copied }) {
+            const int num_iterations = 100000;
+            std::atomic<long> sum{0};
+            arena->execute([&sum] {
+                tbb::parallel_for(0, num_iterations, [&sum](int i) {
+                    sum += i;
+                });
+            });
+            REQUIRE_MESSAGE(sum == long(num_iterations) * (num_iterations - 1) / 2,
+                "Not all the work was executed in the arena with NUMA-aware stealing");
+        }
+    }
+}
+
+//! Reports the variance of the repeated parallel_for timings with the different pinning policies
+//! \brief \ref interface \ref requirement
+TEST_CASE("Test timing variance of pinned arenas") {
+    using thread_pinning = tbb::task_arena::thread_pinning;
+    for (thread_pinning pinning: { thread_pinning::none, thread_pinning::compact, thread_pinning::scatter }) {
+        tbb::task_arena::constraints constraints;
+        constraints.pinning = pinning;
+        tbb::task_arena arena(constraints);
+
+        const int num_repeats = 20;
+        const int size = 1 << 16;
+        // The stencil reads one buffer and writes the other, so the neighbouring chunks do not race
+        std::vector<double> input(size, 1.0), output(size, 1.0);
+        std::vector<double> times;
+        arena.execute([&] {
+            for (int r = 0; r < num_repeats; ++r) {
+                tbb::tick_count t0 = tbb::tick_count::now();
+                for (int step = 0; step < 10; ++step) {
+                    tbb::parallel_for(tbb::blocked_range<int>(1, size - 1), [&input, &output](const tbb::blocked_range<int>& range) {
+                        for (int i = range.begin(); i != range.end(); ++i) {
+                            output[i] = (input[i - 1] + input[i] + input[i + 1]) / 3;
+                        }
+                    }, tbb::static_partitioner{});
+                    std::swap(input, output);
+                }
+                times.push_back((tbb::tick_count::now() - t0).seconds());
+            }
+        });
+        double mean = std::accumulate(times.begin(), times.end(), 0.0) / num_repeats;
+        double variance = 0;
+        for (double t: times) {
+            variance += (t - mean) * (t - mean) / num_repeats;
+        }
+        MESSAGE("pinning = " << int(pinning) << ", mean = " << mean << "s, variance = " << variance);
+        REQUIRE(std::all_of(input.begin(), input.end(), [](double v) { return v > 0.99 && v < 1.01; }));
+    }
+}
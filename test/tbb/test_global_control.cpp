@@ -30,6 +30,7 @@
 #include "tbb/task_group.h"
 #include "tbb/task_arena.h"
 
+#include <atomic>
 #include <cstring>
 
 struct task_scheduler_handle_guard {
@@ -291,3 +292,74 @@ TEST_CASE("simple prolong lifetime 3") {
     tbb::parallel_for(0, 10, TestBlockingTerminateNS::EmptyBody());
 }
 
+
+//! Testing the selection of the worker wait policy
+//! \brief \ref interface \ref requirement
+TEST_CASE("wait policy") {
+    using gc = tbb::global_control;
+    CHECK(gc::active_value(gc::wait_policy) == gc::wait_balanced);
+    {
+        gc power(gc::wait_policy, gc::wait_power_first);
+        CHECK(gc::active_value(gc::wait_policy) == gc::wait_power_first);
+        {
+            gc latency(gc::wait_policy, gc::wait_latency_first);
+            CHECK_MESSAGE(gc::active_value(gc::wait_policy) == gc::wait_latency_first,
+                "The most latency-oriented policy should be preferred");
+            gc balanced(gc::wait_policy, gc::wait_balanced);
+            CHECK(gc::active_value(gc::wait_policy) == gc::wait_latency_first);
+        }
+        CHECK(gc::active_value(gc::wait_policy) == gc::wait_power_first);
+    }
+    CHECK(gc::active_value(gc::wait_policy) == gc::wait_balanced);
+
+    // Workers adapt their spinning to idle gaps of different lengths under every policy
+    for (std::size_t policy : { gc::wait_latency_first, gc::wait_balanced, gc::wait_power_first }) {
+        gc ctl(gc::wait_policy, policy);
+        std::atomic<int> counter{0};
+        for (int gap_us : { 0, 10, 1000 }) {
+            for (int i = 0; i < 10; ++i) {
+                tbb::parallel_for(0, 100, [&](int) { ++counter; });
+                std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            }
+        }
+        REQUIRE(counter == 3 * 10 * 100);
+    }
+}
+
+//! Testing the selection of the worker allotment policy
+//! \brief \ref interface \ref requirement
+TEST_CASE("allotment policy") {
+    using gc = tbb::global_control;
+    CHECK(gc::active_value(gc::allotment_policy) == gc::allotment_responsive);
+    {
+        gc stable(gc::allotment_policy, gc::allotment_stable);
+        CHECK(gc::active_value(gc::allotment_policy) == gc::allotment_stable);
+        {
+            gc responsive(gc::allotment_policy, gc::allotment_responsive);
+            CHECK_MESSAGE(gc::active_value(gc::allotment_policy) == gc::allotment_responsive,
+                "The most responsive policy should be preferred");
+        }
+        CHECK(gc::active_value(gc::allotment_policy) == gc::allotment_stable);
+    }
+    CHECK(gc::active_value(gc::allotment_policy) == gc::allotment_responsive);
+
+    // Two arenas alternate between busy and idle phases, so the workers are reallotted all the time
+    for (std::size_t policy : { gc::allotment_responsive, gc::allotment_stable }) {
+        gc ctl(gc::allotment_policy, policy);
+        tbb::task_arena arenas[2];
+        std::atomic<int> counter{0};
+        const int num_phases = 20;
+        utils::NativeParallelFor(2, [&] (int idx) {
+            for (int phase = 0; phase < num_phases; ++phase) {
+                if (phase % 2 == idx) {
+                    arenas[idx].execute([&counter] {
+                        tbb::parallel_for(0, 1000, [&counter] (int) { ++counter; });
+                    });
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        });
+        REQUIRE(counter == num_phases * 1000);
+    }
+}
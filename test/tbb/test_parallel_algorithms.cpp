@@ -0,0 +1,268 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "common/test.h"
+#include "common/utils.h"
+#include "common/utils_concurrency_limit.h"
+
+#include "tbb/parallel_algorithms.h"
+#include "tbb/global_control.h"
+#include "tbb/task_arena.h"
+#include "tbb/tick_count.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//! \file test_parallel_algorithms.cpp
+//! \brief Test for the parallel algorithms built on parallel_scan and parallel_reduce
+
+static const std::size_t test_sizes[] = { 0, 1, 1000, 100000, 1000000 };
+
+std::vector<int> random_data( std::size_t size, int max_value, unsigned seed ) {
+    utils::FastRandom<> rnd(seed);
+    std::vector<int> data(size);
+    for (auto& value : data) {
+        value = int(rnd.get() % max_value);
+    }
+    return data;
+}
+
+std::vector<int> sorted_random_data( std::size_t size, int max_value, unsigned seed ) {
+    std::vector<int> data = random_data(size, max_value, seed);
+    std::sort(data.begin(), data.end());
+    return data;
+}
+
+struct is_odd {
+    bool operator()( int value ) const { return value % 2 != 0; }
+};
+
+//! Testing parallel_transform_reduce against std::accumulate
+//! \brief \ref requirement \ref interface
+TEST_CASE("parallel_transform_reduce") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : test_sizes) {
+            std::vector<int> a = random_data(size, 100, 1), b = random_data(size, 100, 2);
+
+            std::int64_t squares = 0;
+            for (int value : a) squares += std::int64_t(value) * value;
+            CHECK(tbb::parallel_transform_reduce(a.begin(), a.end(), std::int64_t(5), std::plus<std::int64_t>(),
+                      [](int value) { return std::int64_t(value) * value; }) == squares + 5);
+
+            CHECK(tbb::parallel_transform_reduce(a.begin(), a.end(), b.begin(), std::int64_t(0))
+                  == std::inner_product(a.begin(), a.end(), b.begin(), std::int64_t(0)));
+
+            int expected_max = a.empty() ? -1 : *std::max_element(a.begin(), a.end());
+            CHECK(tbb::parallel_transform_reduce(a.begin(), a.end(), -1,
+                      [](int x, int y) { return std::max(x, y); }, [](int value) { return value; }) == expected_max);
+        }
+    }
+}
+
+//! Testing the stream compaction algorithms against the serial ones
+//! \brief \ref requirement \ref interface
+TEST_CASE("parallel_copy_if, parallel_unique_copy and parallel_partition_copy") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : test_sizes) {
+            std::vector<int> data = random_data(size, 4, 3);
+            std::vector<int> expected(size), result(size);
+
+            auto expected_end = std::copy_if(data.begin(), data.end(), expected.begin(), is_odd());
+            auto result_end = tbb::parallel_copy_if(data.begin(), data.end(), result.begin(), is_odd());
+            REQUIRE(result_end - result.begin() == expected_end - expected.begin());
+            REQUIRE(std::equal(expected.begin(), expected_end, result.begin()));
+
+            expected_end = std::unique_copy(data.begin(), data.end(), expected.begin());
+            result_end = tbb::parallel_unique_copy(data.begin(), data.end(), result.begin());
+            REQUIRE(result_end - result.begin() == expected_end - expected.begin());
+            REQUIRE(std::equal(expected.begin(), expected_end, result.begin()));
+
+            std::vector<int> expected_false(size), result_false(size);
+            auto expected_ends = std::partition_copy(data.begin(), data.end(), expected.begin(),
+                                                     expected_false.begin(), is_odd());
+            auto result_ends = tbb::parallel_partition_copy(data.begin(), data.end(), result.begin(),
+                                                            result_false.begin(), is_odd());
+            REQUIRE(result_ends.first - result.begin() == expected_ends.first - expected.begin());
+            REQUIRE(result_ends.second - result_false.begin() == expected_ends.second - expected_false.begin());
+            REQUIRE(std::equal(expected.begin(), expected_ends.first, result.begin()));
+            REQUIRE(std::equal(expected_false.begin(), expected_ends.second, result_false.begin()));
+        }
+    }
+}
+
+//! Testing the in place algorithms against the serial ones
+//! \brief \ref requirement \ref interface
+TEST_CASE("parallel_partition and parallel_unique") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : test_sizes) {
+            for (int max_value : {1, 3, 1000}) {
+                std::vector<int> data = random_data(size, max_value, 4);
+
+                std::vector<int> partitioned = data;
+                auto point = tbb::parallel_partition(partitioned.begin(), partitioned.end(), is_odd());
+                REQUIRE(point - partitioned.begin() == std::count_if(data.begin(), data.end(), is_odd()));
+                REQUIRE(std::all_of(partitioned.begin(), point, is_odd()));
+                REQUIRE(std::none_of(point, partitioned.end(), is_odd()));
+                std::sort(partitioned.begin(), partitioned.end());
+                std::vector<int> sorted = data;
+                std::sort(sorted.begin(), sorted.end());
+                REQUIRE(partitioned == sorted);
+
+                std::vector<int> expected = data, result = data;
+                expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+                result.erase(tbb::parallel_unique(result.begin(), result.end()), result.end());
+                REQUIRE(result == expected);
+            }
+        }
+    }
+}
+
+//! Testing parallel_unique with move only elements
+//! \brief \ref requirement
+TEST_CASE("parallel_unique with move only elements") {
+    std::vector<int> data = random_data(100000, 3, 5);
+    std::vector<std::unique_ptr<int>> pointers;
+    for (int value : data) {
+        pointers.emplace_back(new int(value));
+    }
+    data.erase(std::unique(data.begin(), data.end()), data.end());
+    auto end = tbb::parallel_unique(pointers.begin(), pointers.end(),
+        [](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) { return *a == *b; });
+    REQUIRE(std::size_t(end - pointers.begin()) == data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        REQUIRE(*pointers[i] == data[i]);
+    }
+}
+
+void test_sorted_operations() {
+    for (std::size_t size1 : test_sizes) {
+        for (std::size_t size2 : {std::size_t(0), size1 / 10, size1 * 2}) {
+            // Few distinct values make the runs of equal keys cross the piece bounds
+            for (int max_value : {10, 1000000}) {
+                std::vector<int> a = sorted_random_data(size1, max_value, 6);
+                std::vector<int> b = sorted_random_data(size2, max_value, 7);
+                std::vector<int> expected(size1 + size2), result(size1 + size2);
+
+                auto expected_end = std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+                auto result_end = tbb::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), result.begin());
+                REQUIRE(result_end == result.end());
+                REQUIRE(result == expected);
+
+                expected_end = std::set_union(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+                result_end = tbb::parallel_set_union(a.begin(), a.end(), b.begin(), b.end(), result.begin());
+                REQUIRE(result_end - result.begin() == expected_end - expected.begin());
+                REQUIRE(std::equal(expected.begin(), expected_end, result.begin()));
+
+                expected_end = std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+                result_end = tbb::parallel_set_intersection(a.begin(), a.end(), b.begin(), b.end(), result.begin());
+                REQUIRE(result_end - result.begin() == expected_end - expected.begin());
+                REQUIRE(std::equal(expected.begin(), expected_end, result.begin()));
+            }
+        }
+    }
+}
+
+//! Testing the operations on sorted sequences against the serial ones
+//! \brief \ref requirement \ref interface
+TEST_CASE("parallel_merge, parallel_set_union and parallel_set_intersection") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        test_sorted_operations();
+    }
+    // The output of the set operations is counted piecewise only if the arena has several slots
+    tbb::task_arena arena(4);
+    arena.execute([] { test_sorted_operations(); });
+}
+
+//! Testing that parallel_merge keeps the elements of the first sequence before the equal ones of the second
+//! \brief \ref requirement
+TEST_CASE("parallel_merge stability") {
+    using item = std::pair<int, int>;
+    auto by_key = [](const item& x, const item& y) { return x.first < y.first; };
+    std::vector<item> a(200000), b(300000);
+    utils::FastRandom<> rnd(8);
+    for (auto& x : a) x = item(int(rnd.get() % 100), 1);
+    for (auto& x : b) x = item(int(rnd.get() % 100), 2);
+    std::stable_sort(a.begin(), a.end(), by_key);
+    std::stable_sort(b.begin(), b.end(), by_key);
+    std::vector<item> expected(a.size() + b.size()), result(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), by_key);
+    tbb::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), result.begin(), by_key);
+    REQUIRE(result == expected);
+}
+
+template<typename Parallel, typename Serial>
+void measure_algorithm( const char* name, std::size_t size, Parallel parallel, Serial serial ) {
+    const int repeats = 3;
+    tbb::tick_count t0 = tbb::tick_count::now();
+    for (int r = 0; r < repeats; ++r) {
+        parallel();
+    }
+    double parallel_time = (tbb::tick_count::now() - t0).seconds() / repeats;
+    t0 = tbb::tick_count::now();
+    for (int r = 0; r < repeats; ++r) {
+        serial();
+    }
+    double serial_time = (tbb::tick_count::now() - t0).seconds() / repeats;
+    MESSAGE(name << " of " << size << " elements: parallel " << parallel_time * 1000 << " ms, serial "
+            << serial_time * 1000 << " ms");
+}
+
+//! Comparing the algorithms with their serial versions
+//! \brief \ref error_guessing
+TEST_CASE("Parallel algorithms performance") {
+    for (std::size_t size : {std::size_t(1) << 14, std::size_t(1) << 18, std::size_t(1) << 22}) {
+        std::vector<int> data = random_data(size, 1000, 9);
+        std::vector<int> few_values = random_data(size, 2, 10);
+        std::vector<int> a = sorted_random_data(size, int(size), 11), b = sorted_random_data(size, int(size), 12);
+        std::vector<int> result(2 * size), result_false(size), work;
+
+        // The sink keeps the compiler from dropping the reductions
+        volatile std::int64_t sink = 0;
+        measure_algorithm("transform_reduce", size,
+            [&] { sink = tbb::parallel_transform_reduce(data.begin(), data.end(), a.begin(), std::int64_t(0)); },
+            [&] { sink = std::inner_product(data.begin(), data.end(), a.begin(), std::int64_t(0)); });
+        measure_algorithm("copy_if", size,
+            [&] { tbb::parallel_copy_if(data.begin(), data.end(), result.begin(), is_odd()); },
+            [&] { std::copy_if(data.begin(), data.end(), result.begin(), is_odd()); });
+        measure_algorithm("partition_copy", size,
+            [&] { tbb::parallel_partition_copy(data.begin(), data.end(), result.begin(), result_false.begin(), is_odd()); },
+            [&] { std::partition_copy(data.begin(), data.end(), result.begin(), result_false.begin(), is_odd()); });
+        measure_algorithm("partition", size,
+            [&] { work = data; tbb::parallel_partition(work.begin(), work.end(), is_odd()); },
+            [&] { work = data; std::partition(work.begin(), work.end(), is_odd()); });
+        measure_algorithm("unique", size,
+            [&] { work = few_values; tbb::parallel_unique(work.begin(), work.end()); },
+            [&] { work = few_values; std::unique(work.begin(), work.end()); });
+        measure_algorithm("merge", size,
+            [&] { tbb::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), result.begin()); },
+            [&] { std::merge(a.begin(), a.end(), b.begin(), b.end(), result.begin()); });
+        measure_algorithm("set_union", size,
+            [&] { tbb::parallel_set_union(a.begin(), a.end(), b.begin(), b.end(), result.begin()); },
+            [&] { std::set_union(a.begin(), a.end(), b.begin(), b.end(), result.begin()); });
+        measure_algorithm("set_intersection", size,
+            [&] { tbb::parallel_set_intersection(a.begin(), a.end(), b.begin(), b.end(), result.begin()); },
+            [&] { std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), result.begin()); });
+    }
+}
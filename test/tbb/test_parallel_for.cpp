@@ -28,11 +28,14 @@
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 #include "tbb/global_control.h"
+#include "tbb/task_arena.h"
 #include "tbb/test_partitioner.h"
 
+#include <atomic>
 #include <cstdio>
 #include <vector>
 #include <sstream>
+#include <utility>
 
 //! \file test_parallel_for.cpp
 //! \brief Test for [algorithms.parallel_for] specification
@@ -346,6 +349,55 @@ TEST_CASE("Various range implementations") {
     various_range_implementations::test();
 }
 
+//! Testing that the subranges mailed by the affinity partitioner are executed exactly once
+//! and mostly by the threads that executed them in the previous run
+//! \brief \ref error_guessing
+TEST_CASE("Affinity partitioner replay") {
+    const std::size_t N = 10000;
+    const int num_replays = 50;
+    for (std::size_t p = utils::MinThread; p <= utils::MaxThread; ++p) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, p);
+        tbb::task_arena arena(int(p), 1);
+        std::vector<std::atomic<int>> counters(N);
+        for (auto& c : counters) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        // The slot that executed each index in the current and in the previous run
+        std::vector<int> slots(N, -1), previous_slots(N, -1);
+        std::size_t num_replayed = 0, num_on_recorded_slot = 0;
+        tbb::affinity_partitioner ap;
+        for (int i = 0; i < num_replays; ++i) {
+            arena.execute([&] {
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, N, 8), [&](const tbb::blocked_range<std::size_t>& r) {
+                    int slot = tbb::this_task_arena::current_thread_index();
+                    for (std::size_t k = r.begin(); k != r.end(); ++k) {
+                        counters[k].fetch_add(1, std::memory_order_relaxed);
+                        slots[k] = slot;
+                    }
+                }, ap);
+            });
+            // The first runs only record the affinity
+            if (i >= num_replays / 2) {
+                for (std::size_t k = 0; k < N; ++k) {
+                    num_on_recorded_slot += slots[k] == previous_slots[k];
+                }
+                num_replayed += N;
+            }
+            std::swap(slots, previous_slots);
+        }
+        for (std::size_t k = 0; k < N; ++k) {
+            REQUIRE_MESSAGE(counters[k].load(std::memory_order_relaxed) == num_replays, "Index " << k << " is not executed exactly once per run");
+        }
+        double on_recorded_slot = double(num_on_recorded_slot) / num_replayed;
+        MESSAGE("threads = " << p << ", executed on the recorded slot: " << on_recorded_slot);
+        // A subrange lands on an arbitrary slot with the probability of 1/p. The check makes sense
+        // only if each thread has its own core, otherwise the threads miss their mail while preempted.
+        if (p > 1 && utils::get_platform_max_threads() >= p) {
+            CHECK_MESSAGE(on_recorded_slot > 1. / p, "The replayed subranges do not follow the recorded affinity");
+        }
+    }
+}
+
 //! Testing parallel_for with explicit task_group_context
 //! \brief \ref interface \ref error_guessing
 TEST_CASE("Сancellation test for tbb::parallel_for") {
@@ -25,6 +25,9 @@
 #include "tbb/tick_count.h"
 #include <vector>
 #include <atomic>
+#include <numeric>
+#include <functional>
+#include <cstdint>
 
 //! \file test_parallel_scan.cpp
 //! \brief Test for [algorithms.parallel_scan] specification
@@ -472,3 +475,133 @@ TEST_CASE("parallel_scan testing with generic lambdas") {
     }
 }
 #endif /* __TBB_CPP14_GENERIC_LAMBDAS_PRESENT */
+
+//! Affine map x -> a*x + b; the composition is associative but not commutative
+struct affine_map {
+    std::int64_t a, b;
+    affine_map( std::int64_t a_ = 1, std::int64_t b_ = 0 ) : a(a_), b(b_) {}
+    bool operator==( const affine_map& other ) const { return a == other.a && b == other.b; }
+};
+
+struct affine_compose {
+    //! Applies lhs first, then rhs
+    affine_map operator()( const affine_map& lhs, const affine_map& rhs ) const {
+        return affine_map(rhs.a * lhs.a, rhs.a * lhs.b + rhs.b);
+    }
+};
+
+//! Testing the iterator based scans against the serial prefix sums
+//! \brief \ref requirement \ref interface
+TEST_CASE("parallel_inclusive_scan and parallel_exclusive_scan") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : {0, 1, 2, 1000, 16 * 1024 * 3 + 7, 1000000}) {
+            std::vector<int> input(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                input[i] = int(i % 7) - 3;
+            }
+            std::vector<int> expected(size), output(size);
+
+            std::partial_sum(input.begin(), input.end(), expected.begin());
+            CHECK(tbb::parallel_inclusive_scan(input.begin(), input.end(), output.begin()) == output.end());
+            REQUIRE(output == expected);
+
+            std::vector<int> in_place = input;
+            tbb::parallel_inclusive_scan(in_place.begin(), in_place.end(), in_place.begin());
+            REQUIRE(in_place == expected);
+
+            for (std::size_t i = 0; i < size; ++i) {
+                expected[i] += 100;
+            }
+            tbb::parallel_inclusive_scan(input.begin(), input.end(), output.begin(), std::plus<int>(), 100);
+            REQUIRE(output == expected);
+
+            for (std::size_t i = 0; i < size; ++i) {
+                expected[i] -= input[i];
+            }
+            CHECK(tbb::parallel_exclusive_scan(input.begin(), input.end(), output.begin(), 100) == output.end());
+            REQUIRE(output == expected);
+
+            in_place = input;
+            tbb::parallel_exclusive_scan(in_place.begin(), in_place.end(), in_place.begin(), 100, std::plus<int>());
+            REQUIRE(in_place == expected);
+
+            // Integral values are summed exactly in floating point, so any order gives the same result
+            std::vector<float> float_input(input.begin(), input.end()), float_output(size);
+            std::vector<float> float_expected(size);
+            std::partial_sum(float_input.begin(), float_input.end(), float_expected.begin());
+            tbb::parallel_inclusive_scan(float_input.begin(), float_input.end(), float_output.begin());
+            REQUIRE(float_output == float_expected);
+        }
+    }
+}
+
+//! Testing that the iterator based scans keep the order of a non-commutative operation
+//! \brief \ref requirement
+TEST_CASE("parallel_inclusive_scan with a non-commutative operation") {
+    const std::size_t size = 200000;
+    std::vector<affine_map> input(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        input[i] = affine_map(i % 3 == 0 ? -1 : 1, std::int64_t(i % 11));
+    }
+    std::vector<affine_map> expected(size), output(size);
+    std::partial_sum(input.begin(), input.end(), expected.begin(), affine_compose());
+    tbb::parallel_inclusive_scan(input.begin(), input.end(), output.begin(), affine_compose());
+    REQUIRE(output == expected);
+
+    std::vector<affine_map> exclusive_expected(size);
+    exclusive_expected[0] = affine_map();
+    std::copy(expected.begin(), expected.end() - 1, exclusive_expected.begin() + 1);
+    tbb::parallel_exclusive_scan(input.begin(), input.end(), output.begin(), affine_map(), affine_compose());
+    REQUIRE(output == exclusive_expected);
+}
+
+template<typename T>
+void measure_scan_bandwidth( const char* name, std::size_t size ) {
+    std::vector<T> input(size, T(1)), output(size);
+    const double bytes = double(2 * size * sizeof(T));
+    const int repeats = 5;
+
+    tbb::tick_count t0 = tbb::tick_count::now();
+    for (int r = 0; r < repeats; ++r) {
+        tbb::parallel_inclusive_scan(input.begin(), input.end(), output.begin());
+    }
+    double iterator_time = (tbb::tick_count::now() - t0).seconds() / repeats;
+    CHECK(output.back() == T(size));
+
+    t0 = tbb::tick_count::now();
+    for (int r = 0; r < repeats; ++r) {
+        tbb::parallel_scan(tbb::blocked_range<std::size_t>(0, size), T(0),
+            [&](const tbb::blocked_range<std::size_t>& range, T sum, bool is_final_scan) {
+                for (std::size_t i = range.begin(); i != range.end(); ++i) {
+                    sum += input[i];
+                    if (is_final_scan) {
+                        output[i] = sum;
+                    }
+                }
+                return sum;
+            },
+            std::plus<T>());
+    }
+    double body_time = (tbb::tick_count::now() - t0).seconds() / repeats;
+    CHECK(output.back() == T(size));
+
+    t0 = tbb::tick_count::now();
+    for (int r = 0; r < repeats; ++r) {
+        std::partial_sum(input.begin(), input.end(), output.begin());
+    }
+    double serial_time = (tbb::tick_count::now() - t0).seconds() / repeats;
+
+    MESSAGE(name << " x " << size << ": parallel_inclusive_scan " << bytes / iterator_time / 1e9
+            << " GB/s, parallel_scan with a body " << bytes / body_time / 1e9
+            << " GB/s, std::partial_sum " << bytes / serial_time / 1e9 << " GB/s");
+}
+
+//! Comparing the bandwidth of the iterator based scan with the body based parallel_scan
+//! \brief \ref error_guessing
+TEST_CASE("parallel_inclusive_scan bandwidth") {
+    for (std::size_t size : {1 << 16, 1 << 20, 1 << 24}) {
+        measure_scan_bandwidth<int>("int", size);
+        measure_scan_bandwidth<float>("float", size);
+    }
+}
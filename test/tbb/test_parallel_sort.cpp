@@ -15,12 +15,14 @@
 */
 
 #include "common/test.h"
+#include "common/utils.h"
 #include "common/utils_concurrency_limit.h"
 #include "common/cpu_usertime.h"
 
 #include "tbb/parallel_sort.h"
 #include "tbb/concurrent_vector.h"
 #include "tbb/global_control.h"
+#include "tbb/tick_count.h"
 
 #include <math.h>
 #include <vector>
@@ -29,6 +31,9 @@
 #include <cstring>
 #include <cstddef>
 #include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
 
 //! \file test_parallel_sort.cpp
 //! \brief Test for [algorithms.parallel_sort]
@@ -311,6 +316,342 @@ TEST_CASE("Array sorting test (default comparator)") {
     }
 }
 
+template<typename T>
+std::vector<T> radix_sort_test_data( std::size_t size, unsigned seed ) {
+    utils::FastRandom<> rnd(seed);
+    std::vector<T> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::uint64_t bits = (std::uint64_t(rnd.get()) << 48) ^ (std::uint64_t(rnd.get()) << 32) ^
+                             (std::uint64_t(rnd.get()) << 16) ^ std::uint64_t(rnd.get());
+        data[i] = T(std::int64_t(bits) % std::int64_t(std::numeric_limits<std::int32_t>::max()));
+        if (std::is_floating_point<T>::value) {
+            data[i] /= T(1000);
+        }
+    }
+    return data;
+}
+
+template<typename T>
+void test_radix_sort_keys( std::size_t size ) {
+    std::vector<T> data = radix_sort_test_data<T>(size, unsigned(size));
+    if (size > 2) {
+        data[0] = std::numeric_limits<T>::lowest();
+        data[1] = (std::numeric_limits<T>::max)();
+        data[2] = T(0);
+    }
+    std::vector<T> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<T> sorted = data;
+    tbb::parallel_radix_sort(sorted.begin(), sorted.end());
+    REQUIRE_MESSAGE(sorted == expected, "parallel_radix_sort has not sorted the data");
+
+    sorted = data;
+    tbb::parallel_sort(sorted.begin(), sorted.end());
+    REQUIRE_MESSAGE(sorted == expected, "parallel_sort has not sorted the data");
+}
+
+//! Testing the radix sort of the integral and floating point keys
+//! \brief \ref error_guessing
+TEST_CASE("Radix sort of arithmetic keys") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : {0, 1, 2, 100, 5000, 70000, 300000}) {
+            test_radix_sort_keys<int>(size);
+            test_radix_sort_keys<unsigned>(size);
+            test_radix_sort_keys<std::int64_t>(size);
+            test_radix_sort_keys<std::uint64_t>(size);
+            test_radix_sort_keys<short>(size);
+            test_radix_sort_keys<float>(size);
+            test_radix_sort_keys<double>(size);
+        }
+    }
+}
+
+//! Testing that the radix sort keeps the order of the elements with equal keys
+//! \brief \ref requirement
+TEST_CASE("Radix sort stability") {
+    struct record {
+        int key;
+        std::size_t index;
+    };
+    const std::size_t size = 200000;
+    std::vector<record> records(size);
+    utils::FastRandom<> rnd(42);
+    for (std::size_t i = 0; i < size; ++i) {
+        records[i] = record{ int(rnd.get() % 1000) - 500, i };
+    }
+    tbb::parallel_radix_sort(records.begin(), records.end(), [](const record& r) { return r.key; });
+    for (std::size_t i = 1; i < size; ++i) {
+        REQUIRE_MESSAGE(records[i - 1].key <= records[i].key, "Records are not sorted by the key");
+        if (records[i - 1].key == records[i].key) {
+            REQUIRE_MESSAGE(records[i - 1].index < records[i].index, "Records with equal keys are reordered");
+        }
+    }
+}
+
+//! Testing the radix sort of a non-contiguous sequence
+//! \brief \ref error_guessing
+TEST_CASE("Radix sort of tbb::concurrent_vector") {
+    std::vector<double> data = radix_sort_test_data<double>(100000, 7);
+    tbb::concurrent_vector<double> vector(data.begin(), data.end());
+    tbb::parallel_radix_sort(vector.begin(), vector.end());
+    std::sort(data.begin(), data.end());
+    REQUIRE(std::equal(data.begin(), data.end(), vector.begin()));
+}
+
+template<typename T>
+void measure_radix_sort( const char* name, std::vector<T> data ) {
+    std::vector<T> sorted = data;
+    tbb::tick_count t0 = tbb::tick_count::now();
+    tbb::parallel_sort(sorted.begin(), sorted.end());
+    double radix_sort_time = (tbb::tick_count::now() - t0).seconds();
+    t0 = tbb::tick_count::now();
+    // A comparator other than std::less forces the quick sort
+    tbb::parallel_sort(data.begin(), data.end(), [](const T& a, const T& b) { return a < b; });
+    double quick_sort_time = (tbb::tick_count::now() - t0).seconds();
+    CHECK(sorted == data);
+    MESSAGE(name << ": radix sort " << radix_sort_time * 1000 << " ms, quick sort "
+            << quick_sort_time * 1000 << " ms for " << data.size() << " elements");
+}
+
+//! Comparing the radix sort path of parallel_sort with the quick sort
+//! \brief \ref error_guessing
+TEST_CASE("Radix sort performance") {
+    const std::size_t size = 1 << 21;
+    measure_radix_sort("std::uint64_t", radix_sort_test_data<std::uint64_t>(size, 1));
+    measure_radix_sort("int", radix_sort_test_data<int>(size, 2));
+    measure_radix_sort("float", radix_sort_test_data<float>(size, 3));
+}
+
+struct stable_sort_record {
+    int key;
+    std::size_t index;
+};
+
+struct stable_sort_record_less {
+    bool operator()( const stable_sort_record& a, const stable_sort_record& b ) const {
+        return a.key < b.key;
+    }
+};
+
+std::vector<stable_sort_record> stable_sort_test_data( std::size_t size, int num_keys, unsigned seed ) {
+    utils::FastRandom<> rnd(seed);
+    std::vector<stable_sort_record> records(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        records[i] = stable_sort_record{ int(rnd.get() % num_keys), i };
+    }
+    return records;
+}
+
+void check_stable_sort( const std::vector<stable_sort_record>& records ) {
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        REQUIRE_MESSAGE(records[i - 1].key <= records[i].key, "Records are not sorted");
+        if (records[i - 1].key == records[i].key) {
+            REQUIRE_MESSAGE(records[i - 1].index < records[i].index, "Records with equal keys are reordered");
+        }
+    }
+}
+
+//! Allocator that counts the allocated elements
+template<typename T>
+struct counting_allocator : std::allocator<T> {
+    template<typename U> struct rebind { using other = counting_allocator<U>; };
+    static std::size_t allocated;
+
+    counting_allocator() = default;
+    template<typename U> counting_allocator( const counting_allocator<U>& ) {}
+
+    T* allocate( std::size_t n ) {
+        allocated += n;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+template<typename T>
+std::size_t counting_allocator<T>::allocated = 0;
+
+//! Testing that parallel_stable_sort keeps the order of equal elements
+//! \brief \ref requirement
+TEST_CASE("Stable sort keeps the order of equal elements") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : {0, 1, 499, 500, 2049, 10000, 100003, 1000000}) {
+            for (int num_keys : {1, 10, 100000}) {
+                std::vector<stable_sort_record> records = stable_sort_test_data(size, num_keys, unsigned(size));
+                tbb::parallel_stable_sort(records.begin(), records.end(), stable_sort_record_less());
+                check_stable_sort(records);
+            }
+        }
+    }
+}
+
+//! Testing the scratch buffer hooks of parallel_stable_sort
+//! \brief \ref interface
+TEST_CASE("Stable sort scratch buffer") {
+    const std::size_t size = 100000;
+    SUBCASE("allocator") {
+        std::vector<stable_sort_record> records = stable_sort_test_data(size, 1000, 1);
+        counting_allocator<int>::allocated = counting_allocator<stable_sort_record>::allocated = 0;
+        tbb::parallel_stable_sort(records.begin(), records.end(), stable_sort_record_less(), counting_allocator<int>());
+        check_stable_sort(records);
+        CHECK(counting_allocator<int>::allocated == 0);
+        CHECK(counting_allocator<stable_sort_record>::allocated == size);
+    }
+    SUBCASE("caller provided buffer") {
+        std::vector<stable_sort_record> records = stable_sort_test_data(size, 1000, 2);
+        std::vector<stable_sort_record> buffer(size);
+        tbb::parallel_stable_sort(records.begin(), records.end(), stable_sort_record_less(), buffer.data());
+        check_stable_sort(records);
+    }
+    SUBCASE("non-trivial elements") {
+        std::vector<std::string> strings(size);
+        utils::FastRandom<> rnd(3);
+        for (auto& str : strings) {
+            str = std::to_string(rnd.get());
+        }
+        std::vector<std::string> expected = strings;
+        std::stable_sort(expected.begin(), expected.end());
+        tbb::parallel_stable_sort(strings);
+        CHECK(strings == expected);
+    }
+    SUBCASE("tbb::concurrent_vector") {
+        std::vector<stable_sort_record> records = stable_sort_test_data(size, 1000, 4);
+        tbb::concurrent_vector<stable_sort_record> vector(records.begin(), records.end());
+        tbb::parallel_stable_sort(vector, stable_sort_record_less());
+        std::stable_sort(records.begin(), records.end(), stable_sort_record_less());
+        for (std::size_t i = 0; i < size; ++i) {
+            REQUIRE(vector[i].index == records[i].index);
+        }
+    }
+}
+
+//! Comparing parallel_stable_sort with std::stable_sort
+//! \brief \ref error_guessing
+TEST_CASE("Stable sort performance") {
+    for (std::size_t size : {1 << 16, 1 << 20, 1 << 23}) {
+        std::vector<stable_sort_record> records = stable_sort_test_data(size, 1 << 16, 5);
+        std::vector<stable_sort_record> expected = records;
+
+        tbb::tick_count t0 = tbb::tick_count::now();
+        std::stable_sort(expected.begin(), expected.end(), stable_sort_record_less());
+        double serial_time = (tbb::tick_count::now() - t0).seconds();
+
+        t0 = tbb::tick_count::now();
+        tbb::parallel_stable_sort(records.begin(), records.end(), stable_sort_record_less());
+        double parallel_time = (tbb::tick_count::now() - t0).seconds();
+
+        for (std::size_t i = 0; i < size; ++i) {
+            REQUIRE(records[i].index == expected[i].index);
+        }
+        MESSAGE(size << " records: std::stable_sort " << serial_time * 1000 << " ms, parallel_stable_sort "
+                << parallel_time * 1000 << " ms");
+    }
+}
+
+std::vector<int> selection_test_data( std::size_t size, unsigned seed ) {
+    utils::FastRandom<> rnd(seed);
+    std::vector<int> data(size);
+    for (auto& value : data) {
+        // Many repeated values exercise the partitioning of equal keys
+        value = int(rnd.get() % (size / 4 + 1));
+    }
+    return data;
+}
+
+//! Testing parallel_partial_sort against std::sort
+//! \brief \ref requirement
+TEST_CASE("Partial sort") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : {0, 1, 100, 5000, 200000}) {
+            std::vector<int> data = selection_test_data(size, unsigned(size));
+            std::vector<int> expected = data;
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+            for (std::size_t k : {std::size_t(0), std::size_t(1), std::size_t(10), size / 3, size}) {
+                if (k > size) continue;
+                std::vector<int> sorted = data;
+                tbb::parallel_partial_sort(sorted.begin(), sorted.begin() + k, sorted.end(), std::greater<int>());
+                REQUIRE_MESSAGE(std::equal(sorted.begin(), sorted.begin() + k, expected.begin()),
+                                "The first elements are not sorted");
+                std::sort(sorted.begin() + k, sorted.end(), std::greater<int>());
+                REQUIRE_MESSAGE(sorted == expected, "The elements are lost");
+            }
+        }
+    }
+}
+
+//! Testing parallel_nth_element against std::sort
+//! \brief \ref requirement
+TEST_CASE("Nth element") {
+    for (auto concurrency_level : utils::concurrency_range()) {
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, concurrency_level);
+        for (std::size_t size : {1, 100, 5000, 200000}) {
+            std::vector<int> data = selection_test_data(size, unsigned(size) + 1);
+            std::vector<int> expected = data;
+            std::sort(expected.begin(), expected.end());
+            for (std::size_t n : {std::size_t(0), size / 2, size - 1}) {
+                std::vector<int> selected = data;
+                tbb::parallel_nth_element(selected.begin(), selected.begin() + n, selected.end());
+                REQUIRE(selected[n] == expected[n]);
+                for (std::size_t i = 0; i < size; ++i) {
+                    REQUIRE_MESSAGE((i < n ? selected[i] <= selected[n] : selected[n] <= selected[i]),
+                                    "The elements are not partitioned around the nth element");
+                }
+            }
+        }
+    }
+}
+
+//! Testing the selection over non-contiguous sequences
+//! \brief \ref error_guessing
+TEST_CASE("Partial sort of tbb::concurrent_vector") {
+    std::vector<int> data = selection_test_data(100000, 11);
+    tbb::concurrent_vector<int> vector(data.begin(), data.end());
+    tbb::parallel_partial_sort(vector.begin(), vector.begin() + 1000, vector.end());
+    std::sort(data.begin(), data.end());
+    REQUIRE(std::equal(data.begin(), data.begin() + 1000, vector.begin()));
+}
+
+//! Comparing parallel_partial_sort and parallel_nth_element with the serial algorithms and the full sort
+//! \brief \ref error_guessing
+TEST_CASE("Partial sort performance") {
+    for (std::size_t size : {1 << 20, 1 << 23}) {
+        std::vector<int> data = selection_test_data(size, 13);
+        for (std::size_t k : {std::size_t(10), std::size_t(1000), size / 100, size / 10, size / 2}) {
+            std::vector<int> parallel = data, serial = data, full = data;
+
+            tbb::tick_count t0 = tbb::tick_count::now();
+            tbb::parallel_partial_sort(parallel.begin(), parallel.begin() + k, parallel.end());
+            double parallel_time = (tbb::tick_count::now() - t0).seconds();
+
+            t0 = tbb::tick_count::now();
+            std::partial_sort(serial.begin(), serial.begin() + k, serial.end());
+            double serial_time = (tbb::tick_count::now() - t0).seconds();
+
+            t0 = tbb::tick_count::now();
+            tbb::parallel_sort(full.begin(), full.end());
+            double full_time = (tbb::tick_count::now() - t0).seconds();
+
+            REQUIRE(std::equal(parallel.begin(), parallel.begin() + k, full.begin()));
+            MESSAGE("N=" << size << " K=" << k << ": parallel_partial_sort " << parallel_time * 1000
+                    << " ms, std::partial_sort " << serial_time * 1000 << " ms, parallel_sort "
+                    << full_time * 1000 << " ms");
+        }
+
+        std::vector<int> parallel = data, serial = data;
+        tbb::tick_count t0 = tbb::tick_count::now();
+        tbb::parallel_nth_element(parallel.begin(), parallel.begin() + size / 2, parallel.end());
+        double parallel_time = (tbb::tick_count::now() - t0).seconds();
+        t0 = tbb::tick_count::now();
+        std::nth_element(serial.begin(), serial.begin() + size / 2, serial.end());
+        double serial_time = (tbb::tick_count::now() - t0).seconds();
+        REQUIRE(parallel[size / 2] == serial[size / 2]);
+        MESSAGE("N=" << size << " median: parallel_nth_element " << parallel_time * 1000
+                << " ms, std::nth_element " << serial_time * 1000 << " ms");
+    }
+}
+
 //! Testing workers going to sleep
 //! \brief \ref resource_usage
 TEST_CASE("That all workers sleep when no work") {
@@ -249,3 +249,33 @@ TEST_CASE("event class") {
     e.emit();
     tbb::profiling::event::emit("emit");
 }
+
+#include "tbb/parallel_for.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+//! Test for the scheduler trace export
+//! \brief \ref interface
+TEST_CASE("Scheduler trace") {
+    const char* file_name = "test_profiling_trace.json";
+    tbb::profiling::clear_scheduler_trace();
+    tbb::parallel_for(0, 1000, [] (int) {});
+    if (tbb::profiling::write_scheduler_trace(file_name)) {
+        std::ifstream file(file_name);
+        std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(file_name);
+        CHECK(trace.find("{\"traceEvents\":[") == 0);
+        CHECK(trace.find("\"thread_name\"") != std::string::npos);
+        // The calling thread spawns and executes the tasks of parallel_for in any case
+        CHECK(trace.find("\"name\":\"spawn\"") != std::string::npos);
+        CHECK(trace.find("\"name\":\"task\",\"cat\":\"tbb\",\"ph\":\"B\"") != std::string::npos);
+        CHECK(trace.find("\"name\":\"task\",\"cat\":\"tbb\",\"ph\":\"E\"") != std::string::npos);
+        CHECK(trace.rfind("]") != std::string::npos);
+    }
+    // The trace cannot be written to a directory
+    CHECK(!tbb::profiling::write_scheduler_trace("."));
+}
@@ -29,6 +29,7 @@
 #include "tbb/parallel_for.h"
 #include "tbb/task_scheduler_observer.h"
 #include "tbb/task_group.h"
+#include "tbb/tick_count.h"
 
 #include <algorithm>
 #include <thread>
@@ -393,6 +394,54 @@ void TestObservers() {
     tracker.observe(false);
 }
 
+// Suspends a task in a short-living arena, so the coroutines of the arena are destroyed
+// and their stacks are returned to the cache
+double RunSuspendingArenas(AsyncActivity& async, int num_arenas) {
+    tbb::tick_count t0 = tbb::tick_count::now();
+    for (int i = 0; i < num_arenas; ++i) {
+        tbb::task_arena arena(2);
+        arena.execute([&async] {
+            tbb::parallel_for(0, N, [&async](int) {
+                tbb::task::suspend(SuspendBody(async));
+            });
+        });
+        arena.terminate();
+    }
+    return (tbb::tick_count::now() - t0).seconds();
+}
+
+void TestCoroutineStackCache() {
+    AsyncActivity async(2);
+    tbb::task::coroutine_stack_statistics before, after;
+    if (!tbb::task::query_coroutine_stack_statistics(before)) {
+        // The coroutine stacks are managed by the system
+        return;
+    }
+    const int num_arenas = 100;
+    double time_with_cache = RunSuspendingArenas(async, num_arenas);
+    tbb::task::query_coroutine_stack_statistics(after);
+    CHECK(after.stacks_allocated + after.stacks_reused > before.stacks_allocated + before.stacks_reused);
+    CHECK(after.stacks_reused > before.stacks_reused);
+
+    {
+        tbb::global_control no_cache(tbb::global_control::coroutine_stack_cache_size, 0);
+        tbb::task::query_coroutine_stack_statistics(before);
+        CHECK(before.stacks_cached == 0);
+        CHECK(before.cached_bytes == 0);
+
+        double time_without_cache = RunSuspendingArenas(async, num_arenas);
+        tbb::task::query_coroutine_stack_statistics(after);
+        CHECK(after.stacks_cached == 0);
+        CHECK(after.stacks_reused == before.stacks_reused);
+        CHECK(after.stacks_released > before.stacks_released);
+        INFO("Time with the stack cache: " << time_with_cache << "s, without: " << time_without_cache << "s");
+    }
+    // The default limit is restored
+    RunSuspendingArenas(async, 1);
+    tbb::task::query_coroutine_stack_statistics(after);
+    CHECK(after.cached_bytes <= tbb::global_control::active_value(tbb::global_control::coroutine_stack_cache_size));
+}
+
 class TestCaseGuard {
     static thread_local bool m_local;
     tbb::global_control m_threadLimit;
@@ -444,4 +493,11 @@ TEST_CASE("Stress test with external threads") {
 TEST_CASE("Arena observer") {
     TestObservers();
 }
+
+//! Test that the coroutine stacks are reused and the cache is limited by global_control
+//! \brief \ref error_guessing
+TEST_CASE("Coroutine stack cache") {
+    TestCaseGuard guard;
+    TestCoroutineStackCache();
+}
 #endif /* __TBB_RESUMABLE_TASKS */
@@ -26,10 +26,16 @@
 #include "tbb/cache_aligned_allocator.h"
 #include "tbb/global_control.h"
 #include "tbb/concurrent_vector.h"
+#include "tbb/concurrent_queue.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_coroutine.h"
 
+#include <algorithm>
 #include <atomic>
 #include <thread>
 #include <thread>
+#include <utility>
+#include <vector>
 
 //! \file test_task.cpp
 //! \brief Test for [internal] functionality
@@ -705,3 +711,258 @@ TEST_CASE("Enqueue with exception") {
     REQUIRE_MESSAGE(task_type::execute_counter() == task_number * iter_count, "Some task was not executed");
     REQUIRE_MESSAGE(task_type::cancel_counter() == 0, "Some task was canceled");
 }
+
+//! \brief \ref error_guessing
+TEST_CASE("Task memory freed by other threads") {
+    using allocator_type = tbb::detail::d1::small_object_allocator;
+    struct object {
+        char data[128];
+    };
+    const std::size_t num_owners = 4, num_objects = 1000;
+    std::vector<std::pair<object*, allocator_type>> objects(num_owners * num_objects);
+
+    // The owners of the pools exit before their objects are freed
+    utils::NativeParallelFor(num_owners, [&objects, num_objects] (std::size_t i) {
+        for (std::size_t j = 0; j < num_objects; ++j) {
+            allocator_type alloc{};
+            objects[i * num_objects + j] = std::make_pair(alloc.new_object<object>(), alloc);
+        }
+    });
+    // Interleave the objects of the pools, so the freeing threads switch between them
+    utils::NativeParallelFor(std::size_t(2), [&objects, num_owners, num_objects] (std::size_t t) {
+        for (std::size_t k = t; k < objects.size(); k += 2) {
+            auto& entry = objects[(k % num_owners) * num_objects + k / num_owners];
+            entry.second.delete_object(entry.first);
+        }
+    });
+
+    // The owner of the pool reuses the objects freed by other threads
+    std::vector<std::pair<object*, allocator_type>> reused(num_objects);
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        for (auto& entry : reused) {
+            entry.second = allocator_type{};
+            entry.first = entry.second.new_object<object>();
+        }
+        utils::NativeParallelFor(std::size_t(2), [&reused] (std::size_t t) {
+            for (std::size_t k = t; k < reused.size(); k += 2) {
+                reused[k].second.delete_object(reused[k].first);
+            }
+        });
+    }
+}
+
+// Builds a binary tree of nested contexts; some leaves cancel one of their ancestors
+struct cancellation_tree_builder {
+    static constexpr int max_depth = 10;
+    std::atomic<int>& num_violations;
+
+    void operator()(int level, tbb::task_group_context** chain, unsigned seed) const {
+        tbb::task_group_context ctx;
+        chain[level] = &ctx;
+        tbb::parallel_for(0, 2, [&] (int i) {
+            tbb::task_group_context* local_chain[max_depth + 1];
+            std::copy(chain, chain + level + 1, local_chain);
+            unsigned child_seed = seed * 2 + unsigned(i) + 1;
+            if (level + 1 < max_depth) {
+                (*this)(level + 1, local_chain, child_seed);
+                return;
+            }
+            if (child_seed * 2654435761u % 16 != 0) {
+                return;
+            }
+            // The root of the tree is never cancelled
+            int cancelled_level = 1 + int(child_seed % unsigned(level));
+            local_chain[cancelled_level]->cancel_group_execution();
+            for (int j = cancelled_level; j <= level; ++j) {
+                if (!local_chain[j]->is_group_execution_cancelled()) {
+                    ++num_violations;
+                }
+            }
+            // The context bound to a cancelled one is cancelled as well
+            tbb::task_group_context fresh;
+            tbb::parallel_for(0, 1, [] (int) {}, fresh);
+            if (!fresh.is_group_execution_cancelled()) {
+                ++num_violations;
+            }
+        }, ctx);
+    }
+};
+
+//! \brief \ref stress
+TEST_CASE("Cancellation of deep context trees") {
+    std::atomic<int> num_violations{0};
+    std::atomic<int> num_wrongly_cancelled{0};
+    utils::NativeParallelFor(2, [&] (int t) {
+        for (unsigned iteration = 0; iteration < 20; ++iteration) {
+            tbb::task_group_context root;
+            tbb::task_group_context unrelated;
+            tbb::task_group_context* chain[cancellation_tree_builder::max_depth + 1];
+            chain[0] = &root;
+            tbb::parallel_for(0, 1, [&] (int) {
+                cancellation_tree_builder{num_violations}(1, chain, iteration * 2 + unsigned(t));
+            }, root);
+            // The cancellations do not leak out of the cancelled subtrees
+            if (root.is_group_execution_cancelled()) {
+                ++num_wrongly_cancelled;
+            }
+            tbb::parallel_for(0, 1, [] (int) {}, unrelated);
+            if (unrelated.is_group_execution_cancelled()) {
+                ++num_wrongly_cancelled;
+            }
+        }
+    });
+    REQUIRE(num_violations == 0);
+    REQUIRE(num_wrongly_cancelled == 0);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Reset of a context with a cancelled ancestor") {
+    tbb::task_group_context root;
+    bool cancelled_after_reset = false;
+    tbb::parallel_for(0, 1, [&] (int) {
+        tbb::task_group_context bound;
+        // Binds the context to the root
+        tbb::parallel_for(0, 1, [] (int) {}, bound);
+        root.cancel_group_execution();
+        bound.reset();
+        // The reset does not hide the cancellation of the ancestor
+        cancelled_after_reset = bound.is_group_execution_cancelled();
+    }, root);
+    REQUIRE(cancelled_after_reset);
+}
+
+#if __TBB_CPP20_COROUTINES_PRESENT
+// Emulates the completion thread of an asynchronous I/O interface
+class async_resumer {
+    tbb::concurrent_queue<tbb::task::coroutine_suspend_point> my_queue;
+    std::atomic<bool> my_is_done{false};
+    std::thread my_thread;
+public:
+    async_resumer() : my_thread([this] {
+        tbb::task::coroutine_suspend_point sp{};
+        while (!my_is_done.load(std::memory_order_acquire) || !my_queue.empty()) {
+            if (my_queue.try_pop(sp)) {
+                tbb::task::resume(sp);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }) {}
+
+    ~async_resumer() {
+        my_is_done.store(true, std::memory_order_release);
+        my_thread.join();
+    }
+
+    void operator()(tbb::task::coroutine_suspend_point sp) {
+        my_queue.push(sp);
+    }
+};
+
+struct frame_guard {
+    std::atomic<int>& num_destroyed;
+    ~frame_guard() { ++num_destroyed; }
+};
+
+tbb::task::coroutine_task async_job(tbb::task_group& tg, async_resumer& resumer, int num_waits,
+                                    std::atomic<int>& num_resumed, std::atomic<int>& num_destroyed) {
+    frame_guard guard{num_destroyed};
+    for (int i = 0; i < num_waits; ++i) {
+        co_await tbb::task::suspend_coroutine(tg, [&resumer] (tbb::task::coroutine_suspend_point sp) { resumer(sp); });
+        ++num_resumed;
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Stackless coroutines in task_group") {
+    const int num_jobs = 10000;
+    const int num_waits = 3;
+    for (std::size_t p = utils::MinThread; p <= utils::MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        std::atomic<int> num_resumed{0};
+        std::atomic<int> num_destroyed{0};
+        {
+            async_resumer resumer;
+            tbb::task_group tg;
+            for (int i = 0; i < num_jobs; ++i) {
+                tg.run(async_job(tg, resumer, num_waits, num_resumed, num_destroyed));
+            }
+            REQUIRE(tg.wait() == tbb::complete);
+            // The group waits for the suspended coroutines
+            REQUIRE(num_resumed == num_jobs * num_waits);
+            REQUIRE(num_destroyed == num_jobs);
+        }
+
+        // The coroutines resumed in the cancelled group are destroyed at their suspension points
+        num_resumed = 0;
+        num_destroyed = 0;
+        {
+            const int num_cancelled_jobs = 100;
+            tbb::concurrent_queue<tbb::task::coroutine_suspend_point> suspended;
+            std::atomic<int> num_suspended{0};
+            tbb::task_group tg;
+            // The last suspended coroutine cancels the group and resumes all of them
+            auto keep = [&] (tbb::task::coroutine_suspend_point sp) {
+                suspended.push(sp);
+                if (++num_suspended == num_cancelled_jobs) {
+                    tg.cancel();
+                    tbb::task::coroutine_suspend_point s{};
+                    while (suspended.try_pop(s)) {
+                        tbb::task::resume(s);
+                    }
+                }
+            };
+            auto job = [&] () -> tbb::task::coroutine_task {
+                frame_guard guard{num_destroyed};
+                co_await tbb::task::suspend_coroutine(tg, keep);
+                ++num_resumed;
+            };
+            for (int i = 0; i < num_cancelled_jobs; ++i) {
+                tg.run(job());
+            }
+            REQUIRE(tg.wait() == tbb::canceled);
+            REQUIRE(num_resumed == 0);
+            REQUIRE(num_destroyed == num_cancelled_jobs);
+        }
+    }
+}
+
+#if TBB_USE_EXCEPTIONS
+//! \brief \ref error_guessing
+TEST_CASE("Exception from a resumed coroutine") {
+    std::atomic<int> num_destroyed{0};
+    async_resumer resumer;
+    tbb::task_group tg;
+    auto job = [&] () -> tbb::task::coroutine_task {
+        frame_guard guard{num_destroyed};
+        co_await tbb::task::suspend_coroutine(tg, [&resumer] (tbb::task::coroutine_suspend_point sp) { resumer(sp); });
+        throw std::runtime_error("coroutine exception");
+    };
+    tg.run(job());
+    REQUIRE_THROWS_AS(tg.wait(), std::runtime_error);
+    REQUIRE(num_destroyed == 1);
+}
+#endif // TBB_USE_EXCEPTIONS
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Stackless coroutines in task_arena") {
+    const int num_jobs = 1000;
+    tbb::task_arena arena;
+    std::atomic<int> num_completed{0};
+    {
+        async_resumer resumer;
+        auto job = [&] () -> tbb::task::coroutine_task {
+            for (int i = 0; i < 2; ++i) {
+                co_await tbb::task::suspend_coroutine(arena, [&resumer] (tbb::task::coroutine_suspend_point sp) { resumer(sp); });
+                // The coroutine is resumed in the arena
+                CHECK(tbb::this_task_arena::current_thread_index() >= 0);
+            }
+            ++num_completed;
+        };
+        for (int i = 0; i < num_jobs; ++i) {
+            arena.enqueue(job());
+        }
+        utils::SpinWaitUntilEq(num_completed, num_jobs);
+    }
+}
+#endif // __TBB_CPP20_COROUTINES_PRESENT
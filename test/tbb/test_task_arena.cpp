@@ -30,6 +30,7 @@
 #include "tbb/concurrent_set.h"
 #include "tbb/spin_mutex.h"
 #include "tbb/spin_rw_mutex.h"
+#include "tbb/tick_count.h"
 
 #include <stdexcept>
 #include <cstdlib>
@@ -37,6 +38,9 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 
 //#include "harness_fp.h"
 
@@ -1836,3 +1840,400 @@ TEST_CASE("Workers oversubscription") {
         );
     });
 }
+
+//! Test for concurrent producers and consumers of enqueued tasks
+//! \brief \ref stress
+TEST_CASE("Concurrent enqueue") {
+    const int num_producers = 4;
+    // Enough tasks to overflow the bounded lanes of the task stream
+    const int tasks_per_producer = 10000;
+    tbb::task_arena arena(utils::get_platform_max_threads() + 1, 1);
+    std::atomic<int> executed{0};
+    utils::NativeParallelFor(num_producers, [&] (int) {
+        for (int i = 0; i < tasks_per_producer; ++i) {
+            arena.enqueue([&executed] { ++executed; });
+        }
+    });
+    // Enqueued tasks are processed by workers even if the platform has a single core
+    while (executed < num_producers * tasks_per_producer) {
+        std::this_thread::yield();
+    }
+    REQUIRE(executed == num_producers * tasks_per_producer);
+}
+
+//! Test for the scheduler statistics reported by the arena
+//! \brief \ref interface
+TEST_CASE("Arena statistics") {
+    tbb::task_arena arena(2);
+    tbb::arena_statistics stats;
+    CHECK_MESSAGE(!arena.query_statistics(stats), "Statistics of an uninitialized arena are not available");
+    CHECK(stats.tasks_executed == 0);
+
+    arena.initialize();
+    std::atomic<int> counter{0};
+    const int num_iterations = 1000;
+    arena.execute([&] {
+        tbb::parallel_for(0, num_iterations, 1, [&] (int) { ++counter; });
+    });
+    REQUIRE(counter == num_iterations);
+
+    if (arena.query_statistics(stats)) {
+        // The outermost parallel_for body is executed by the calling thread in any case.
+        CHECK(stats.tasks_spawned > 0);
+        CHECK(stats.tasks_executed > 0);
+        CHECK(stats.tasks_stolen <= stats.tasks_executed);
+        CHECK(stats.mailbox_hits <= stats.tasks_executed);
+
+        tbb::arena_statistics next;
+        arena.execute([&] {
+            tbb::parallel_for(0, num_iterations, 1, [&] (int) { ++counter; });
+        });
+        REQUIRE(arena.query_statistics(next));
+        CHECK(next.tasks_executed > stats.tasks_executed);
+        CHECK(next.tasks_spawned > stats.tasks_spawned);
+    } else {
+        // The library is built without scheduler statistics
+        CHECK(stats.tasks_spawned == 0);
+        CHECK(stats.tasks_executed == 0);
+        CHECK(stats.tasks_stolen == 0);
+        CHECK(stats.failed_steal_attempts == 0);
+        CHECK(stats.mailbox_hits == 0);
+        CHECK(stats.proxies_dropped == 0);
+        CHECK(stats.worker_pause_time_ns == 0);
+    }
+}
+
+//! Test for the concurrent creation and destruction of short-lived arenas of different priorities
+//! \brief \ref stress
+TEST_CASE("Short-lived arenas of different priorities") {
+    const int num_threads = 8;
+    const int num_arenas_per_thread = 100;
+    const tbb::task_arena::priority priorities[] = {
+        tbb::task_arena::priority::low, tbb::task_arena::priority::normal, tbb::task_arena::priority::high
+    };
+    std::atomic<int> counter{0};
+    // Keeps the workers busy with arena migrations meanwhile
+    tbb::task_arena long_lived_arena;
+    long_lived_arena.enqueue([&counter] {
+        tbb::parallel_for(0, 10000, [&counter] (int) { ++counter; });
+    });
+    utils::NativeParallelFor(num_threads, [&] (int thread_index) {
+        for (int i = 0; i < num_arenas_per_thread; ++i) {
+            tbb::task_arena arena(2, 1, priorities[(thread_index + i) % 3]);
+            arena.execute([&counter] {
+                tbb::parallel_for(0, 10, [&counter] (int) { ++counter; });
+            });
+        }
+    });
+    long_lived_arena.execute([] {});
+    REQUIRE(counter >= num_threads * num_arenas_per_thread * 10);
+}
+
+class pairing_observer : public tbb::task_scheduler_observer {
+    tbb::enumerable_thread_specific<int> my_depth{0};
+    std::atomic<int>& my_num_violations;
+    void on_scheduler_entry( bool is_worker ) override {
+        if (my_depth.local()++ != 0) {
+            ++my_num_violations;
+        }
+        if (!is_worker) {
+            ++num_external_entries;
+        }
+    }
+    void on_scheduler_exit( bool ) override {
+        if (--my_depth.local() != 0) {
+            ++my_num_violations;
+        }
+    }
+public:
+    std::atomic<int> num_external_entries{0};
+
+    pairing_observer(tbb::task_arena& a, std::atomic<int>& num_violations)
+        : tbb::task_scheduler_observer(a), my_num_violations(num_violations) {}
+    ~pairing_observer() {
+        observe(false);
+    }
+};
+
+//! Test for the entry and exit notifications in short execute bursts while the observers change
+//! \brief \ref stress
+TEST_CASE("Observers of short execute bursts") {
+    const int num_threads = 4;
+    const int num_executes = 1000;
+    // More than the observers notified under one lock acquisition
+    const int num_observers = 20;
+    std::atomic<int> num_violations{0};
+    // Every external thread gets a slot, so its execute calls are not delegated to other threads
+    tbb::task_arena arena(num_threads + 2, num_threads + 1);
+    std::vector<std::unique_ptr<pairing_observer>> observers;
+    for (int i = 0; i < num_observers; ++i) {
+        observers.emplace_back(new pairing_observer(arena, num_violations));
+        observers.back()->observe(true);
+    }
+    std::atomic<bool> done{false};
+    utils::NativeParallelFor(num_threads + 1, [&] (int thread_index) {
+        if (thread_index == num_threads) {
+            // Keep adding and removing observers meanwhile
+            while (!done) {
+                pairing_observer toggled(arena, num_violations);
+                toggled.observe(true);
+                arena.execute([] {});
+            }
+            return;
+        }
+        for (int i = 0; i < num_executes; ++i) {
+            arena.execute([] {
+                tbb::parallel_for(0, 4, [] (int) {});
+            });
+        }
+        if (thread_index == 0) {
+            done = true;
+        }
+    });
+    REQUIRE(num_violations == 0);
+    for (auto& o : observers) {
+        // Each execute call from outside of the arena enters it as an external thread
+        REQUIRE(o->num_external_entries >= num_threads * num_executes);
+    }
+}
+
+//! Test for the demand of an arena whose worker slots are occupied by short execute calls
+//! \brief \ref stress
+TEST_CASE("Short execute calls in worker slots") {
+    const int num_threads = 4;
+    const int num_executes = 10000;
+    // No slots are reserved, so the external threads always occupy the worker slots
+    tbb::task_arena arena(num_threads + 1, 0);
+    std::atomic<long> sum{0};
+    utils::NativeParallelFor(num_threads, [&] (int) {
+        for (int i = 0; i < num_executes; ++i) {
+            if (i % 100 == 0) {
+                arena.execute([&sum] {
+                    tbb::parallel_for(0, 100, [&sum] (int j) { sum += j; });
+                });
+            } else {
+                arena.execute([&sum] { ++sum; });
+            }
+        }
+    });
+    REQUIRE(sum == long(num_threads) * (num_executes / 100 * 4950 + num_executes - num_executes / 100));
+
+    // The arena still requests the workers for the enqueued work
+    std::atomic<bool> executed{false};
+    arena.enqueue([&executed] { executed = true; });
+    while (!executed) {
+        std::this_thread::yield();
+    }
+}
+
+//! Test that execute calls finding a free slot run inline without delegating the functor
+//! \brief \ref interface
+TEST_CASE("Short execute calls take the fast path") {
+    const int num_threads = 4;
+    const int num_executes = 1000;
+    // Every external thread has a reserved slot, so none of them has to wait for a slot
+    tbb::task_arena arena(num_threads, num_threads);
+    arena.initialize();
+    std::atomic<int> counter{0};
+    utils::NativeParallelFor(num_threads, [&] (int) {
+        const std::thread::id caller = std::this_thread::get_id();
+        for (int i = 0; i < num_executes; ++i) {
+            arena.execute([&] {
+                CHECK(std::this_thread::get_id() == caller);
+                CHECK(tbb::this_task_arena::current_thread_index() != tbb::task_arena::not_initialized);
+                ++counter;
+            });
+        }
+    });
+    REQUIRE(counter == num_threads * num_executes);
+
+    tbb::arena_statistics stats;
+    arena.query_statistics(stats);
+    REQUIRE_MESSAGE(stats.delegated_executions == 0, "Execute calls with a free slot must not be delegated");
+
+    // Both slots of the arena are taken by the holding threads, so the next call has to be delegated
+    const int num_slots = 2;
+    tbb::task_arena busy_arena(num_slots, num_slots);
+    std::atomic<int> num_entered{0};
+    std::atomic<bool> release{false};
+    std::vector<std::thread> holders;
+    for (int i = 0; i < num_slots; ++i) {
+        holders.emplace_back([&] {
+            busy_arena.execute([&] {
+                ++num_entered;
+                utils::SpinWaitUntilEq(release, true);
+            });
+        });
+    }
+    utils::SpinWaitUntilEq(num_entered, num_slots);
+    std::thread waiter([&] {
+        busy_arena.execute([&] { ++counter; });
+    });
+    // Wait until the execute call is delegated before releasing the slots
+    do {
+        std::this_thread::yield();
+        busy_arena.query_statistics(stats);
+    } while (stats.delegated_executions == 0);
+    release = true;
+    for (auto& holder : holders) {
+        holder.join();
+    }
+    waiter.join();
+    REQUIRE(stats.delegated_executions == 1);
+    REQUIRE(counter == num_threads * num_executes + 1);
+}
+
+//! Reports the overhead of task_arena::execute calls with a tiny functor
+//! \brief \ref interface
+TEST_CASE("Latency of short execute calls") {
+    const int num_calls = 100000;
+    std::atomic<int> counter{0};
+    auto body = [&counter] { counter.fetch_add(1, std::memory_order_relaxed); };
+    auto measure = [num_calls] (const std::function<void()>& call) {
+        tbb::tick_count t0 = tbb::tick_count::now();
+        for (int i = 0; i < num_calls; ++i) {
+            call();
+        }
+        return (tbb::tick_count::now() - t0).seconds() * 1e9 / num_calls;
+    };
+
+    tbb::task_arena reserved_slot_arena(2, 1);
+    tbb::task_arena worker_slot_arena(2, 0);
+    reserved_slot_arena.initialize();
+    worker_slot_arena.initialize();
+
+    double direct = measure(body);
+    double same_arena = 0;
+    reserved_slot_arena.execute([&] {
+        same_arena = measure([&] { reserved_slot_arena.execute(body); });
+    });
+    double reserved_slot = measure([&] { reserved_slot_arena.execute(body); });
+    double worker_slot = measure([&] { worker_slot_arena.execute(body); });
+    double isolated = measure([&] { tbb::this_task_arena::isolate(body); });
+
+    REQUIRE(counter == 5 * num_calls);
+    // Nobody else competes for the slots, so all the calls take the fast path
+    tbb::arena_statistics stats;
+    reserved_slot_arena.query_statistics(stats);
+    CHECK(stats.delegated_executions == 0);
+    worker_slot_arena.query_statistics(stats);
+    CHECK(stats.delegated_executions == 0);
+    MESSAGE("Nanoseconds per call: direct " << direct << ", same arena " << same_arena
+        << ", reserved slot " << reserved_slot << ", worker slot " << worker_slot << ", isolate " << isolated);
+}
+
+//! Test that the tasks enqueued with deadlines are taken in the earliest-deadline-first order
+//! \brief \ref interface \ref requirement
+TEST_CASE("Deadline ordered enqueue") {
+    using clock = std::chrono::steady_clock;
+    const int num_tasks = 10;
+    // A single worker executes all the enqueued tasks one after another
+    tbb::task_arena arena(2, 1);
+    std::atomic<bool> started{false}, release{false};
+    arena.enqueue([&] {
+        started = true;
+        utils::SpinWaitUntilEq(release, true);
+    });
+    utils::SpinWaitUntilEq(started, true);
+
+    std::vector<int> order(num_tasks, -1);
+    std::atomic<int> num_executed{0};
+    const clock::time_point now = clock::now();
+    for (int i = 0; i < num_tasks; ++i) {
+        // The later a task is enqueued the earlier its deadline is
+        arena.enqueue([&order, &num_executed, i] { order[num_executed++] = i; },
+                      now + std::chrono::hours(num_tasks - i));
+    }
+    release = true;
+    utils::SpinWaitUntilEq(num_executed, num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+        CHECK(order[i] == num_tasks - 1 - i);
+    }
+
+    tbb::arena_statistics stats;
+    arena.query_statistics(stats);
+    CHECK(stats.missed_deadlines == 0);
+
+    // The tasks with the passed deadlines are still executed but counted as missed
+    std::atomic<int> num_late{0};
+    for (int i = 0; i < num_tasks; ++i) {
+        arena.enqueue([&num_late] { ++num_late; }, now - std::chrono::seconds(1));
+    }
+    utils::SpinWaitUntilEq(num_late, num_tasks);
+    arena.query_statistics(stats);
+    CHECK(stats.missed_deadlines == std::uint64_t(num_tasks));
+}
+
+//! Reports the deadline miss rate of an arena under different loads with the earliest-deadline-first and FIFO orders
+//! \brief \ref interface
+TEST_CASE("Deadline miss rate under overload") {
+    using clock = std::chrono::steady_clock;
+    const int num_tasks = 1000;
+    const auto task_duration = std::chrono::microseconds(20);
+    const auto total_work = std::chrono::duration_cast<clock::duration>(task_duration * num_tasks);
+
+    auto busy_wait = [task_duration] {
+        const clock::time_point start = clock::now();
+        while (clock::now() - start < task_duration) {
+            std::this_thread::yield();
+        }
+    };
+
+    // Returns the share of the tasks started after their deadlines
+    auto run = [&] (const std::vector<clock::duration>& deadline_offsets, bool use_deadlines) {
+        // A single worker executes all the enqueued tasks one after another
+        tbb::task_arena arena(2, 1);
+        std::atomic<int> num_executed{0}, num_late{0};
+        std::atomic<bool> started{false};
+        // The worker is held back until all the tasks are enqueued
+        const clock::time_point start = clock::now() + std::chrono::milliseconds(100);
+        arena.enqueue([&] {
+            started = true;
+            while (clock::now() < start) {
+                std::this_thread::yield();
+            }
+        });
+        utils::SpinWaitUntilEq(started, true);
+        for (int i = 0; i < num_tasks; ++i) {
+            const clock::time_point deadline = start + deadline_offsets[i];
+            auto body = [&, deadline] {
+                if (clock::now() > deadline) {
+                    ++num_late;
+                }
+                busy_wait();
+                ++num_executed;
+            };
+            if (use_deadlines) {
+                arena.enqueue(body, deadline);
+            } else {
+                arena.enqueue(body);
+            }
+        }
+        utils::SpinWaitUntilEq(num_executed, num_tasks);
+
+        tbb::arena_statistics stats;
+        arena.query_statistics(stats);
+        if (use_deadlines) {
+            // The tasks are checked against their deadlines a bit later than the scheduler does it
+            CHECK(stats.missed_deadlines <= std::uint64_t(num_late));
+        } else {
+            CHECK(stats.missed_deadlines == 0);
+        }
+        return double(num_late) / num_tasks;
+    };
+
+    utils::FastRandom<> random(42);
+    // The load is the ratio of the total work to the time span of the deadlines
+    for (double load : { 0.5, 0.9, 2.0 }) {
+        std::vector<clock::duration> deadline_offsets(num_tasks);
+        const auto deadline_spread = std::chrono::duration_cast<clock::duration>(total_work / load);
+        for (auto& offset : deadline_offsets) {
+            // Leave enough time for the earliest task
+            offset = task_duration * 2 + deadline_spread * (random.get() % 1000) / 1000;
+        }
+        double edf_miss_rate = run(deadline_offsets, /*use_deadlines*/ true);
+        double fifo_miss_rate = run(deadline_offsets, /*use_deadlines*/ false);
+        MESSAGE("Deadline miss rate with load " << load << ": earliest deadline first " << edf_miss_rate
+            << ", FIFO " << fifo_miss_rate);
+    }
+}
@@ -0,0 +1,229 @@
+/*
+    Copyright (c) 2020 Intel Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "common/test.h"
+#include "common/utils.h"
+
+#include "tbb/global_control.h"
+#include "tbb/task_dag.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+//! \file test_task_dag.cpp
+//! \brief Test for [scheduler.task_dag] specification
+
+unsigned MinThread = 1;
+unsigned MaxThread = 4;
+const int tree_depth = 10;
+
+// Each node checks that its predecessors have completed and marks itself as completed
+struct dag_checker {
+    std::vector<std::vector<int>> predecessors;
+    std::vector<std::atomic<bool>> completed;
+    std::atomic<int> num_violations{0};
+
+    explicit dag_checker(std::size_t num_nodes) : predecessors(num_nodes), completed(num_nodes) {
+        for (auto& c : completed) {
+            c.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void execute(int i) {
+        for (int p : predecessors[i]) {
+            if (!completed[p].load(std::memory_order_acquire)) {
+                ++num_violations;
+            }
+        }
+        completed[i].store(true, std::memory_order_release);
+    }
+
+    int num_completed() const {
+        int n = 0;
+        for (auto& c : completed) {
+            n += c.load(std::memory_order_relaxed) ? 1 : 0;
+        }
+        return n;
+    }
+};
+
+// Builds a layered DAG where every node depends on a few nodes of the previous layer
+void TestLayeredDag(int width, int depth) {
+    const int num_nodes = width * depth;
+    dag_checker checker(num_nodes);
+    tbb::task_dag dag;
+    std::vector<tbb::task_dag::node> nodes;
+    for (int i = 0; i < num_nodes; ++i) {
+        nodes.push_back(dag.add([&checker, i] { checker.execute(i); }));
+    }
+    for (int layer = 1; layer < depth; ++layer) {
+        for (int k = 0; k < width; ++k) {
+            int i = layer * width + k;
+            for (int p : { (k + width - 1) % width, k, (k + 1) % width }) {
+                int pred = (layer - 1) * width + p;
+                if (std::find(checker.predecessors[i].begin(), checker.predecessors[i].end(), pred) == checker.predecessors[i].end()) {
+                    checker.predecessors[i].push_back(pred);
+                    dag.make_edge(nodes[pred], nodes[i]);
+                }
+            }
+        }
+    }
+    REQUIRE(dag.wait() == tbb::complete);
+    REQUIRE(checker.num_violations == 0);
+    REQUIRE(checker.num_completed() == num_nodes);
+}
+
+//! Test for the order of the node execution
+//! \brief \ref interface \ref requirement
+TEST_CASE("Dependencies") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        // Diamond: B and C run after A, D runs after B and C
+        {
+            std::atomic<int> stamp{0};
+            int a = -1, b = -1, c = -1, d = -1;
+            tbb::task_dag dag;
+            auto nd = dag.add([&] { d = stamp++; });
+            auto nb = dag.add([&] { b = stamp++; });
+            auto nc = dag.add([&] { c = stamp++; });
+            auto na = dag.add([&] { a = stamp++; });
+            dag.make_edge(na, nb);
+            dag.make_edge(na, nc);
+            dag.make_edge(nb, nd);
+            dag.make_edge(nc, nd);
+            REQUIRE(dag.wait() == tbb::complete);
+            REQUIRE(a == 0);
+            REQUIRE(((b == 1 && c == 2) || (b == 2 && c == 1)));
+            REQUIRE(d == 3);
+        }
+        TestLayeredDag(1, 100);
+        TestLayeredDag(100, 1);
+        TestLayeredDag(100, 100);
+    }
+}
+
+//! Test for adding the nodes and the edges while the DAG is running
+//! \brief \ref interface \ref requirement
+TEST_CASE("Dynamic dependencies") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        // The edges from the completed nodes have no effect
+        {
+            tbb::task_dag dag;
+            std::atomic<int> counter{0};
+            auto first = dag.add([&counter] { ++counter; });
+            REQUIRE(dag.wait() == tbb::complete);
+            REQUIRE(counter == 1);
+
+            auto a = dag.add([&counter] { ++counter; });
+            auto b = dag.add([&counter] { ++counter; });
+            dag.run();
+            auto c = dag.add([&counter] { ++counter; });
+            dag.make_edge(a, c);
+            dag.make_edge(b, c);
+            REQUIRE(dag.wait() == tbb::complete);
+            REQUIRE(counter == 4);
+            tbb::detail::suppress_unused_warning(first);
+        }
+        // Every node adds the next level of a binary tree. The join of the children of a node
+        // becomes a predecessor of the join of its parent while the parent join is waiting.
+        {
+            tbb::task_dag dag;
+            std::atomic<int> num_nodes{0};
+            std::atomic<int> num_violations{0};
+            struct tree_builder {
+                tbb::task_dag& dag;
+                std::atomic<int>& num_nodes;
+                std::atomic<int>& num_violations;
+
+                void operator()(int level, tbb::task_dag::node parent_join, std::atomic<int>* parent_children) const {
+                    ++num_nodes;
+                    if (level == tree_depth) {
+                        ++*parent_children;
+                        return;
+                    }
+                    auto children = std::make_shared<std::atomic<int>>(0);
+                    std::atomic<int>* violations = &num_violations;
+                    auto join = dag.add([children, parent_children, violations] {
+                        if (*children != 2) {
+                            ++*violations;
+                        }
+                        if (parent_children) {
+                            ++*parent_children;
+                        }
+                    });
+                    if (parent_join) {
+                        dag.make_edge(join, parent_join);
+                    }
+                    tree_builder builder = *this;
+                    for (int i = 0; i < 2; ++i) {
+                        auto child = dag.add([builder, level, join, children] {
+                            builder(level + 1, join, children.get());
+                        });
+                        dag.make_edge(child, join);
+                    }
+                    dag.run();
+                }
+            };
+            tree_builder builder{dag, num_nodes, num_violations};
+            dag.add([builder] { builder(0, tbb::task_dag::node{}, nullptr); });
+            REQUIRE(dag.wait() == tbb::complete);
+            REQUIRE(num_violations == 0);
+            REQUIRE(num_nodes == (1 << (tree_depth + 1)) - 1);
+        }
+    }
+}
+
+//! Test for the cancellation of the DAG
+//! \brief \ref interface \ref requirement
+TEST_CASE("Cancellation") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        tbb::task_dag dag;
+        std::atomic<int> num_executed{0};
+        const int num_nodes = 100;
+        tbb::task_dag::node prev = dag.add([&] { ++num_executed; dag.cancel(); });
+        for (int i = 1; i < num_nodes; ++i) {
+            tbb::task_dag::node next = dag.add([&num_executed] { ++num_executed; });
+            dag.make_edge(prev, next);
+            prev = next;
+        }
+        REQUIRE(dag.wait() == tbb::canceled);
+        REQUIRE(num_executed == 1);
+
+        // The DAG is reusable after the cancellation
+        dag.add([&num_executed] { ++num_executed; });
+        REQUIRE(dag.wait() == tbb::complete);
+        REQUIRE(num_executed == 2);
+    }
+}
+
+#if TBB_USE_EXCEPTIONS
+//! Test for the exception propagation from a node
+//! \brief \ref error_guessing
+TEST_CASE("Exception propagation") {
+    tbb::task_dag dag;
+    std::atomic<bool> successor_executed{false};
+    auto a = dag.add([] { throw std::runtime_error("node exception"); });
+    auto b = dag.add([&successor_executed] { successor_executed = true; });
+    dag.make_edge(a, b);
+    REQUIRE_THROWS_AS(dag.wait(), std::runtime_error);
+    REQUIRE(!successor_executed);
+}
+#endif // TBB_USE_EXCEPTIONS
@@ -28,6 +28,9 @@
 #include "common/concurrency_tracker.h"
 
 #include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
 
 //! \file test_task_group.cpp
 //! \brief Test for [scheduler.task_group scheduler.task_group_status] specification
@@ -977,3 +980,230 @@ TEST_CASE("Async task group") {
         });
     });
 }
+
+template <typename TaskGroup>
+void TestRunBatch() {
+    for (std::size_t batch_size : { 0, 1, 63, 64, 65, 1000 }) {
+        std::atomic<std::size_t> counter{0};
+        auto body = [&counter] { ++counter; };
+        std::vector<decltype(body)> bodies(batch_size, body);
+        TaskGroup tg;
+        tg.run_batch(bodies.begin(), bodies.end());
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(counter == batch_size);
+    }
+
+    // Tree traversal that spawns all the children of a node at once
+    const int fanout = 8, depth = 4;
+    std::atomic<int> num_nodes{0};
+    TaskGroup tg;
+    std::function<void(int)> visit = [&] (int level) {
+        ++num_nodes;
+        if (level < depth) {
+            std::vector<std::function<void()>> children(fanout, [&visit, level] { visit(level + 1); });
+            tg.run_batch(children.begin(), children.end());
+        }
+    };
+    tg.run([&visit] { visit(0); });
+    tg.wait();
+    int expected_nodes = 0;
+    for (int level = 0, width = 1; level <= depth; ++level, width *= fanout) {
+        expected_nodes += width;
+    }
+    REQUIRE(num_nodes == expected_nodes);
+}
+
+//! Test for spawning a batch of tasks with a single publication
+//! \brief \ref interface \ref requirement
+TEST_CASE("Batched run") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        TestRunBatch<tbb::task_group>();
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+        TestRunBatch<tbb::isolated_task_group>();
+#endif
+    }
+}
+
+template<typename TaskGroup>
+void TestRunWithPriority() {
+    // A single thread takes high priority tasks first and low priority tasks last
+    tbb::task_arena arena(1, 1);
+    arena.execute([] {
+        std::vector<tbb::task_priority> order;
+        TaskGroup tg;
+        tg.run([&order] { order.push_back(tbb::task_priority::low); }, tbb::task_priority::low);
+        tg.run([&order] { order.push_back(tbb::task_priority::normal); });
+        tg.run([&order] { order.push_back(tbb::task_priority::high); }, tbb::task_priority::high);
+        REQUIRE(tg.wait() == tbb::complete);
+        std::vector<tbb::task_priority> expected{ tbb::task_priority::high, tbb::task_priority::normal, tbb::task_priority::low };
+        REQUIRE(order == expected);
+    });
+
+    // Tasks of all priorities are executed when spawned concurrently
+    const int num_tasks = 1000;
+    std::atomic<int> counter{0};
+    TaskGroup tg;
+    tg.run([&] {
+        for (int i = 0; i < num_tasks; ++i) {
+            tg.run([&counter] { ++counter; }, tbb::task_priority(i % 3));
+        }
+    });
+    REQUIRE(tg.wait() == tbb::complete);
+    REQUIRE(counter == num_tasks);
+}
+
+//! Test for running tasks with different priorities within an arena
+//! \brief \ref interface \ref requirement
+TEST_CASE("Run with priority") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        TestRunWithPriority<tbb::task_group>();
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+        TestRunWithPriority<tbb::isolated_task_group>();
+#endif
+    }
+}
+
+template<typename TaskGroup>
+void TestDeferredTasks() {
+    // The task returned from the body is executed right after it by the same thread
+    {
+        TaskGroup tg;
+        std::atomic<int> num_bypassed{0};
+        const int num_tasks = 100;
+        for (int i = 0; i < num_tasks; ++i) {
+            tg.run([&tg, &num_bypassed] {
+                std::thread::id tid = std::this_thread::get_id();
+                return tg.defer([tid, &num_bypassed] {
+                    if (std::this_thread::get_id() == tid) {
+                        ++num_bypassed;
+                    }
+                });
+            });
+        }
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(num_bypassed == num_tasks);
+    }
+    // A task that has never been run does not block the group
+    {
+        TaskGroup tg;
+        bool executed = false;
+        {
+            tbb::task_handle h = tg.defer([&executed] { executed = true; });
+            tbb::task_handle moved = std::move(h);
+            CHECK(!h);
+            CHECK(moved);
+        }
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(!executed);
+
+        tbb::task_handle h = tg.defer([&executed] { executed = true; });
+        tg.run(std::move(h));
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(executed);
+    }
+}
+
+// Computes Fibonacci numbers in the continuation-passing style: the sum is calculated by
+// a continuation of the two subproblems, one of which is bypassed. The continuation is passed
+// on as the successor of the continuations of the subproblems.
+template<typename TaskGroup>
+struct continuation_fib {
+    TaskGroup& tg;
+
+    tbb::task_handle operator()(int n, int& result, tbb::continuation successor) const {
+        if (n < 2) {
+            result = n;
+            return tbb::task_handle{};
+        }
+        int* x = new int{};
+        int* y = new int{};
+        tbb::continuation sum = tg.make_continuation([x, y, &result] {
+            result = *x + *y;
+            delete x;
+            delete y;
+        }, 2, successor);
+        continuation_fib fib{tg};
+        tg.run([fib, n, x, sum] { return fib(n - 1, *x, sum); }, sum);
+        return tg.defer([fib, n, y, sum] { return fib(n - 2, *y, sum); }, sum);
+    }
+};
+
+template<typename TaskGroup>
+void TestContinuations() {
+    const int n = 20, expected = 6765;
+    {
+        TaskGroup tg;
+        int result = 0;
+        continuation_fib<TaskGroup> fib{tg};
+        tg.run([fib, &result] { return fib(n, result, tbb::continuation{}); });
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(result == expected);
+    }
+    // Continuations of the cancelled tasks are cancelled too and the group completes
+    {
+        TaskGroup tg;
+        std::atomic<int> num_continuations{0};
+        const int num_predecessors = 10;
+        tbb::continuation c = tg.make_continuation([&num_continuations] { ++num_continuations; }, num_predecessors);
+        tg.cancel();
+        for (int i = 0; i < num_predecessors; ++i) {
+            tg.run([] {}, c);
+        }
+        REQUIRE(tg.wait() == tbb::canceled);
+        REQUIRE(num_continuations == 0);
+    }
+    // A dropped deferred task releases its continuation; the last one destroys the whole chain
+    {
+        TaskGroup tg;
+        std::atomic<int> num_continuations{0};
+        tbb::continuation outer = tg.make_continuation([&num_continuations] { ++num_continuations; }, 1);
+        // The inner continuation becomes the second predecessor of the outer one
+        tbb::continuation inner = tg.make_continuation([&num_continuations] { ++num_continuations; }, 1, outer);
+        {
+            tbb::task_handle dropped = tg.defer([] {}, outer);
+        }
+        {
+            tbb::task_handle dropped = tg.defer([] {}, inner);
+        }
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(num_continuations == 0);
+    }
+    // The continuation still runs if a predecessor that is not the last one is dropped
+    {
+        TaskGroup tg;
+        std::atomic<int> num_continuations{0};
+        tbb::continuation c = tg.make_continuation([&num_continuations] { ++num_continuations; }, 2);
+        {
+            tbb::task_handle dropped = tg.defer([] {}, c);
+        }
+        tg.run([] {}, c);
+        REQUIRE(tg.wait() == tbb::complete);
+        REQUIRE(num_continuations == 1);
+    }
+}
+
+//! Test for tasks returned from the task bodies to bypass the task pool
+//! \brief \ref interface \ref requirement
+TEST_CASE("Task bypass") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        TestDeferredTasks<tbb::task_group>();
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+        TestDeferredTasks<tbb::isolated_task_group>();
+#endif
+    }
+}
+
+//! Test for dependency-counted continuations
+//! \brief \ref interface \ref requirement
+TEST_CASE("Continuations") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        TestContinuations<tbb::task_group>();
+#if TBB_PREVIEW_ISOLATED_TASK_GROUP
+        TestContinuations<tbb::isolated_task_group>();
+#endif
+    }
+}
@@ -225,6 +225,7 @@ static void DefinitionPresence() {
     TestTypeDefinitionPresence( speculative_spin_rw_mutex );
     TestTypeDefinitionPresence( task_group_context );
     TestTypeDefinitionPresence( task_group );
+    TestTypeDefinitionPresence( task_dag );
     /* Algorithm related names */
     TestTypeDefinitionPresence( blocked_range<int> );
     TestTypeDefinitionPresence( blocked_range2d<int> );